@@ -10,13 +10,14 @@ set -e
 
 echo "Starting auto-build script..."
 
+# Set environment variables
+BOARDS_TINY="--board attiny85"
+BOARDS_AVR="--board uno --board megaatmega2560 --board leonardo"
+BOARDS_ESP="--board d1_mini --board nodemcuv2 --board lolin_d32"
+
 
 function autobuild()
 {
-    # Set environment variables
-    BOARDS_AVR="--board uno --board megaatmega2560 --board leonardo"
-    BOARDS_ESP="--board d1_mini --board nodemcuv2 --board lolin_d32"
-
     echo "Installing library dependencies"
     platformio lib --global install https://github.com/Erriez/ErriezTimestamp.git
     platformio lib --global install https://github.com/Erriez/ErriezSerialTerminal
@@ -25,16 +26,57 @@ function autobuild()
     platformio ci --lib="examples/ErriezDS1302Alarm" --lib="." ${BOARDS_AVR} ${BOARDS_ESP} examples/ErriezDS1302Alarm/ErriezDS1302Alarm.ino
     platformio ci --lib="." ${BOARDS_AVR} ${BOARDS_ESP} examples/ErriezDS1302Benchmark/ErriezDS1302Benchmark.ino
     platformio ci --lib="." ${BOARDS_AVR} ${BOARDS_ESP} examples/ErriezDS1302DumpRegisters/ErriezDS1302DumpRegisters.ino
+    platformio ci --lib="." ${BOARDS_AVR} ${BOARDS_ESP} examples/ErriezDS1302EventStamp/ErriezDS1302EventStamp.ino
+    platformio ci --lib="." ${BOARDS_AVR} ${BOARDS_ESP} examples/ErriezDS1302FastStart/ErriezDS1302FastStart.ino
+    platformio ci --lib="." ${BOARDS_TINY} ${BOARDS_AVR} ${BOARDS_ESP} examples/ErriezDS1302Minimal/ErriezDS1302Minimal.ino
     platformio ci --lib="." ${BOARDS_AVR} ${BOARDS_ESP} examples/ErriezDS1302RAM/ErriezDS1302RAM.ino
+    platformio ci --lib="." ${BOARDS_AVR} ${BOARDS_ESP} examples/ErriezDS1302RAMMirror/ErriezDS1302RAMMirror.ino
     platformio ci --lib="." ${BOARDS_AVR} ${BOARDS_ESP} examples/ErriezDS1302SetBuildDateTime/ErriezDS1302SetBuildDateTime.ino
     platformio ci --lib="." ${BOARDS_AVR} ${BOARDS_ESP} examples/ErriezDS1302SetGetDateTime/ErriezDS1302SetGetDateTime.ino
     platformio ci --lib="." ${BOARDS_AVR} ${BOARDS_ESP} examples/ErriezDS1302SetGetTime/ErriezDS1302SetGetTime.ino
     platformio ci --lib="." ${BOARDS_AVR} ${BOARDS_ESP} examples/ErriezDS1302SetTrickleCharger/ErriezDS1302SetTrickleCharger.ino
+    platformio ci --lib="." ${BOARDS_AVR} ${BOARDS_ESP} examples/ErriezDS1302SharedBus/ErriezDS1302SharedBus.ino
     platformio ci --lib="." ${BOARDS_AVR} ${BOARDS_ESP} examples/ErriezDS1302Terminal/ErriezDS1302Terminal.ino
     platformio ci --lib="." ${BOARDS_AVR} ${BOARDS_ESP} examples/ErriezDS1302Test/ErriezDS1302Test.ino
+    platformio ci --lib="." ${BOARDS_AVR} ${BOARDS_ESP} examples/ErriezDS1302TimeLog/ErriezDS1302TimeLog.ino
+    platformio ci --lib="." ${BOARDS_AVR} ${BOARDS_ESP} examples/ErriezDS1302TimeZone/ErriezDS1302TimeZone.ino
+    PLATFORMIO_BUILD_FLAGS="-DDS1302_TRACE" platformio ci --lib="." ${BOARDS_AVR} ${BOARDS_ESP} examples/ErriezDS1302Trace/ErriezDS1302Trace.ino
     platformio ci --lib="." ${BOARDS_AVR} ${BOARDS_ESP} examples/ErriezDS1302WriteRead/ErriezDS1302WriteRead.ino
 }
 
+function size_report()
+{
+    # Build the Minimal example for every board and flag combination, and report flash and RAM
+    BOARDS_SIZE=$(echo ${BOARDS_TINY} ${BOARDS_AVR} ${BOARDS_ESP} | sed 's/--board //g')
+    PROFILES=("full|"
+              "no-epoch|-DDS1302_FEATURE_EPOCH=0"
+              "no-tm|-DDS1302_FEATURE_TM=0"
+              "no-ram|-DDS1302_FEATURE_RAM=0"
+              "no-bus|-DDS1302_FEATURE_BUS=0"
+              "minimal|-DDS1302_MINIMAL"
+              "minimal+tm|-DDS1302_MINIMAL -DDS1302_FEATURE_TM=1"
+              "minimal+tm-ep|-DDS1302_MINIMAL -DDS1302_FEATURE_TM=1 -DDS1302_FEATURE_EPOCH=0"
+              "minimal+ram|-DDS1302_MINIMAL -DDS1302_FEATURE_RAM=1"
+              "minimal+bus|-DDS1302_MINIMAL -DDS1302_FEATURE_BUS=1")
+    SIZE_DIR=".pio-size"
+    SIZE_REPORT="${SIZE_DIR}/size-report.txt"
+
+    echo "Generate size report..."
+
+    mkdir -p ${SIZE_DIR}
+    printf "%-14s %-14s %8s %8s\n" "Board" "Profile" "Flash" "RAM" > ${SIZE_REPORT}
+    for BOARD in ${BOARDS_SIZE}; do
+        for PROFILE in "${PROFILES[@]}"; do
+            OUTPUT=$(PLATFORMIO_BUILD_FLAGS="${PROFILE#*|}" platformio ci --lib="." --board ${BOARD} examples/ErriezDS1302Minimal/ErriezDS1302Minimal.ino)
+            FLASH=$(echo "${OUTPUT}" | grep "^Flash:" | sed -E 's/.*used ([0-9]+) bytes.*/\1/')
+            RAM=$(echo "${OUTPUT}" | grep "^RAM:" | sed -E 's/.*used ([0-9]+) bytes.*/\1/')
+            printf "%-14s %-14s %8s %8s\n" ${BOARD} ${PROFILE%%|*} ${FLASH} ${RAM} >> ${SIZE_REPORT}
+        done
+    done
+
+    cat ${SIZE_REPORT}
+}
+
 function generate_doxygen()
 {
     echo "Generate Doxygen HTML..."
@@ -61,5 +103,6 @@ function generate_doxygen()
 }
 
 autobuild
+size_report
 generate_doxygen
 
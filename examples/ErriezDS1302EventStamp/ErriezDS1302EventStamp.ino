@@ -0,0 +1,127 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \brief DS1302 RTC interrupt event timestamp example for Arduino
+ * \details
+ *    Source:         https://github.com/Erriez/ErriezDS1302
+ *    Documentation:  https://erriez.github.io/ErriezDS1302
+ *
+ *    Pulses on the event pin are timestamped in the interrupt handler with micros() only and
+ *    converted to RTC wall-clock time with milliseconds in the main loop.
+ */
+
+#include <ErriezDS1302.h>
+#include <ErriezDS1302EventStamp.h>
+
+// Connect DS1302 data pin to Arduino DIGITAL pin
+#if defined(ARDUINO_ARCH_AVR)
+// Pins 2 and 3 are the external interrupt pins of the UNO
+#define DS1302_CLK_PIN      4
+#define DS1302_IO_PIN       5
+#define DS1302_CE_PIN       6
+#define EVENT_PIN           2
+#elif defined(ARDUINO_ARCH_ESP8266)
+// Swap D2 and D4 pins for the ESP8266, because pin D2 is high during a
+// power-on / MCU reset / and flashing. This corrupts RTC registers.
+#define DS1302_CLK_PIN      D4 // Pin is high during power-on / reset / flashing
+#define DS1302_IO_PIN       D3
+#define DS1302_CE_PIN       D2
+#define EVENT_PIN           D5
+#elif defined(ARDUINO_ARCH_ESP32)
+#define DS1302_CLK_PIN      0
+#define DS1302_IO_PIN       4
+#define DS1302_CE_PIN       5
+#define EVENT_PIN           15
+#else
+#error #error "May work, but not tested on this target"
+#endif
+
+// Create DS1302 RTC object
+ErriezDS1302 rtc = ErriezDS1302(DS1302_CLK_PIN, DS1302_IO_PIN, DS1302_CE_PIN);
+
+// Create event timestamp object
+ErriezDS1302EventStamp events = ErriezDS1302EventStamp(&rtc);
+
+
+#if defined(ARDUINO_ARCH_ESP8266) || defined(ARDUINO_ARCH_ESP32)
+IRAM_ATTR
+#endif
+void eventHandler()
+{
+    // Only micros() and a queue push
+    events.stamp();
+}
+
+void setup()
+{
+    // Initialize serial port
+    delay(500);
+    Serial.begin(115200);
+    while (!Serial) {
+        ;
+    }
+    Serial.println(F("\nErriez DS1302 RTC event timestamp example\n"));
+
+    // Initialize RTC
+    while (!rtc.begin()) {
+        Serial.println(F("RTC not found"));
+        delay(3000);
+    }
+
+    // Enable RTC clock
+    rtc.clockEnable(true);
+
+    // Wait for a seconds change
+    while (!events.sync()) {
+        Serial.println(F("RTC not running"));
+    }
+
+    // Timestamp rising edges on the event pin
+    pinMode(EVENT_PIN, INPUT_PULLUP);
+    attachInterrupt(digitalPinToInterrupt(EVENT_PIN), eventHandler, RISING);
+}
+
+void loop()
+{
+    time_t t;
+    uint16_t ms;
+    char ms_str[8];
+
+    // Keep the anchor at the RTC seconds change
+    events.update();
+
+    // Print queued events
+    while (events.pop(&t, &ms)) {
+        snprintf(ms_str, sizeof(ms_str), ".%03u", ms);
+        Serial.print(F("Event: "));
+        Serial.print((uint32_t)t);
+        Serial.println(ms_str);
+    }
+
+    if (events.getDropped()) {
+        Serial.print(F("Dropped events: "));
+        Serial.println(events.getDropped());
+    }
+}
@@ -0,0 +1,118 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \brief DS1302 RTC fast start example for Arduino
+ * \details
+ *    Source:         https://github.com/Erriez/ErriezDS1302
+ *    Documentation:  https://erriez.github.io/ErriezDS1302
+ *
+ *    Probes the RTC with a single clock burst read after every (simulated) wake-up and programs
+ *    the date/time only when it has been lost. A warm-boot flag in RTC RAM marks the date/time
+ *    as set by this application.
+ */
+
+#include <ErriezDS1302.h>
+#include <ErriezDS1302BuildTime.h>
+
+// Connect DS1302 data pin to Arduino DIGITAL pin
+#if defined(ARDUINO_ARCH_AVR)
+#define DS1302_CLK_PIN      2
+#define DS1302_IO_PIN       3
+#define DS1302_CE_PIN       4
+#elif defined(ARDUINO_ARCH_ESP8266)
+// Swap D2 and D4 pins for the ESP8266, because pin D2 is high during a
+// power-on / MCU reset / and flashing. This corrupts RTC registers.
+#define DS1302_CLK_PIN      D4 // Pin is high during power-on / reset / flashing
+#define DS1302_IO_PIN       D3
+#define DS1302_CE_PIN       D2
+#elif defined(ARDUINO_ARCH_ESP32)
+#define DS1302_CLK_PIN      0
+#define DS1302_IO_PIN       4
+#define DS1302_CE_PIN       5
+#else
+#error #error "May work, but not tested on this target"
+#endif
+
+// RTC RAM address of the warm-boot flag
+#define WARM_BOOT_ADDR      30
+
+// Create RTC object
+ErriezDS1302 rtc = ErriezDS1302(DS1302_CLK_PIN, DS1302_IO_PIN, DS1302_CE_PIN);
+
+
+void wakeUp()
+{
+    struct tm dt;
+    uint32_t tStart;
+    uint32_t tFast;
+    uint8_t status;
+
+    // Probe RTC and read date/time
+    tStart = micros();
+    status = rtc.beginFast(&dt, WARM_BOOT_ADDR);
+    tFast = micros() - tStart;
+
+    if (!(status & DS1302_FAST_PRESENT)) {
+        Serial.println(F("RTC not found"));
+        return;
+    }
+
+    if (!(status & DS1302_FAST_WARM_BOOT)) {
+        // Cold boot: date/time lost or not set by this application
+        static constexpr uint8_t buildTime[] = DS1302_BUILD_TIME_BLOCK;
+        static_assert(sizeof(buildTime) == (DS1302_NUM_CLOCK_REGS + 1), "Clock burst block size");
+
+        Serial.println(F("Cold boot: set build date/time"));
+        rtc.writeBuffer(0, buildTime, sizeof(buildTime));
+        rtc.writeByteRAM(WARM_BOOT_ADDR, DS1302_WARM_BOOT_MAGIC);
+        rtc.read(&dt);
+    }
+
+    Serial.print(F("beginFast(): "));
+    Serial.print(tFast);
+    Serial.print(F("us, status 0x"));
+    Serial.println(status, HEX);
+    Serial.print(asctime(&dt));
+    Serial.println();
+}
+
+void setup()
+{
+    // Initialize serial port
+    delay(500);
+    Serial.begin(115200);
+    while (!Serial) {
+        ;
+    }
+    Serial.println(F("\nErriez DS1302 RTC fast start example\n"));
+}
+
+void loop()
+{
+    wakeUp();
+
+    // Replace with deep sleep
+    delay(5000);
+}
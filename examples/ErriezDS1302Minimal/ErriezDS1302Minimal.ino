@@ -0,0 +1,108 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \brief DS1302 RTC minimal footprint example for ATtiny85 and other small targets
+ * \details
+ *    Source:         https://github.com/Erriez/ErriezDS1302
+ *    Documentation:  https://erriez.github.io/ErriezDS1302
+ *
+ *    Uses raw seconds of the day and two RAM bytes only, without Serial. Build with the
+ *    minimal profile and RAM enabled, for example in platformio.ini:
+ *      build_flags = -DDS1302_MINIMAL -DDS1302_FEATURE_RAM=1
+ *
+ *    The LED is on during the first half of every minute. A boot counter is kept in RTC RAM.
+ */
+
+#include <ErriezDS1302.h>
+
+// Connect DS1302 data pin to Arduino DIGITAL pin
+#if defined(ARDUINO_AVR_ATTINYX5) || defined(__AVR_ATtiny85__)
+#define DS1302_CLK_PIN      2
+#define DS1302_IO_PIN       3
+#define DS1302_CE_PIN       4
+#define LED_PIN             1
+#elif defined(ARDUINO_ARCH_AVR)
+#define DS1302_CLK_PIN      2
+#define DS1302_IO_PIN       3
+#define DS1302_CE_PIN       4
+#define LED_PIN             LED_BUILTIN
+#elif defined(ARDUINO_ARCH_ESP8266)
+// Swap D2 and D4 pins for the ESP8266, because pin D2 is high during a
+// power-on / MCU reset / and flashing. This corrupts RTC registers.
+#define DS1302_CLK_PIN      D4 // Pin is high during power-on / reset / flashing
+#define DS1302_IO_PIN       D3
+#define DS1302_CE_PIN       D2
+#define LED_PIN             LED_BUILTIN
+#elif defined(ARDUINO_ARCH_ESP32)
+#define DS1302_CLK_PIN      0
+#define DS1302_IO_PIN       4
+#define DS1302_CE_PIN       5
+#define LED_PIN             2
+#else
+#error #error "May work, but not tested on this target"
+#endif
+
+// RTC RAM address of the 16-bit boot counter, 2 Bytes
+#define BOOT_COUNT_ADDR     0
+
+// Create RTC object
+ErriezDS1302 rtc = ErriezDS1302(DS1302_CLK_PIN, DS1302_IO_PIN, DS1302_CE_PIN);
+
+
+void setup()
+{
+    pinMode(LED_PIN, OUTPUT);
+
+    // Initialize RTC
+    while (!rtc.begin()) {
+        delay(1000);
+    }
+
+    // Start at 00:00:00 when the oscillator was halted
+    if (!rtc.isRunning()) {
+        rtc.setTime(0, 0, 0);
+    }
+
+#if DS1302_FEATURE_RAM
+    // Increment boot counter
+    uint16_t bootCount = rtc.readByteRAM(BOOT_COUNT_ADDR) |
+                         (rtc.readByteRAM(BOOT_COUNT_ADDR + 1) << 8);
+    bootCount++;
+    rtc.writeByteRAM(BOOT_COUNT_ADDR, bootCount & 0xFF);
+    rtc.writeByteRAM(BOOT_COUNT_ADDR + 1, bootCount >> 8);
+#endif
+}
+
+void loop()
+{
+    uint32_t seconds;
+
+    // Read seconds of the day with one 3-byte burst
+    if (rtc.getSecondsOfDay(&seconds)) {
+        digitalWrite(LED_PIN, ((seconds % 60) < 30) ? HIGH : LOW);
+    }
+
+    delay(100);
+}
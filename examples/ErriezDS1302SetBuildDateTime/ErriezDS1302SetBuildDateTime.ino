@@ -30,6 +30,7 @@
  */
 
 #include <ErriezDS1302.h>
+#include <ErriezDS1302BuildTime.h>
 
 // Connect DS1302 data pin to Arduino DIGITAL pin
 #if defined(ARDUINO_ARCH_AVR)
@@ -64,88 +65,27 @@ void rtcInit()
         Serial.println(F("RTC not found"));
         delay(3000);
     }
-
-    // Enable RTC clock
-    rtc.clockEnable(true);
-}
-
-bool getBuildTime(const char *str)
-{
-    int hour;
-    int minute;
-    int second;
-
-    // Convert build time macro to time
-    if (sscanf(str, "%d:%d:%d", &hour, &minute, &second) != 3) {
-        return false;
-    }
-
-    dt.tm_hour = hour;
-    dt.tm_min = minute;
-    dt.tm_sec = second;
-
-    return true;
-}
-
-bool getBuildDate(const char *str)
-{
-    const char *monthName[] = {
-        "Jan", "Feb", "Mar", "Apr", "May", "Jun",
-        "Jul", "Aug", "Sep", "Oct", "Nov", "Dec"
-    };
-    uint8_t monthIndex;
-    char month[12];
-    int dayMonth;
-    int year;
-    time_t t;
-
-    // Convert build time macro to date
-    if (sscanf(str, "%s %d %d", month, &dayMonth, &year) != 3) {
-        return false;
-    }
-
-    // Convert month string to month number
-    for (monthIndex = 0; monthIndex < 12; monthIndex++) {
-        if (strcmp(month, monthName[monthIndex]) == 0) {
-            break;
-        }
-    }
-    if (monthIndex >= 12) {
-        // Not found
-        return false;
-    }
-
-    // Set date
-    dt.tm_mday = dayMonth;
-    dt.tm_mon = monthIndex;
-    dt.tm_year = year - 1900;
-
-    // Calculate day of the week
-    t = mktime(&dt);
-    dt.tm_wday = localtime(&t)->tm_wday;
-
-    return true;
 }
 
 bool rtcSetDateTime()
 {
-    // Convert compile date/time to date/time string
-    if (!getBuildDate(__DATE__) || !getBuildTime(__TIME__)) {
-        Serial.print(F("Build date/time error"));
-        return false;
-    }
+    // Build date/time converted to clock registers at compile time
+    static constexpr uint8_t buildTime[] = DS1302_BUILD_TIME_BLOCK;
+    static_assert(sizeof(buildTime) == (DS1302_NUM_CLOCK_REGS + 1), "Clock burst block size");
 
     // Print build date/time
     Serial.print(F("Build date time: "));
-    Serial.println(asctime(&dt));
+    Serial.print(F(__DATE__));
+    Serial.print(F(" "));
+    Serial.println(F(__TIME__));
 
-    // Set new date time
+    // Set new date time with a single clock burst write
     Serial.print(F("Set RTC date time..."));
-    if (!rtc.write(&dt)) {
+    if (!rtc.writeBuffer(0, buildTime, sizeof(buildTime))) {
         Serial.println(F("FAILED"));
-    } else {
-        Serial.println(F("OK"));
+        return false;
     }
+    Serial.println(F("OK"));
 
     return true;
 }
@@ -165,7 +105,7 @@ void setup()
 
     // Set date/time
     if (!rtcSetDateTime()) {
-        // Could not parse build date/time to program RTC
+        // Could not program RTC
         while (1) {
             delay(1000);
         }
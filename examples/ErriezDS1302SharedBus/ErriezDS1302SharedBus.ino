@@ -0,0 +1,112 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \brief DS1302 RTC shared bus example for Arduino
+ * \details
+ *    Source:         https://github.com/Erriez/ErriezDS1302
+ *    Documentation:  https://erriez.github.io/ErriezDS1302
+ *
+ *    Two DS1302 RTC's share the CLK and IO pins and have a separate CE pin.
+ */
+
+#include <ErriezDS1302.h>
+#include <ErriezDS1302Bus.h>
+
+// Connect DS1302 data pins to Arduino DIGITAL pins
+#if defined(ARDUINO_ARCH_AVR)
+#define DS1302_CLK_PIN      2
+#define DS1302_IO_PIN       3
+#define DS1302_CE1_PIN      4
+#define DS1302_CE2_PIN      5
+#elif defined(ARDUINO_ARCH_ESP8266)
+// Swap D2 and D4 pins for the ESP8266, because pin D2 is high during a
+// power-on / MCU reset / and flashing. This corrupts RTC registers.
+#define DS1302_CLK_PIN      D4 // Pin is high during power-on / reset / flashing
+#define DS1302_IO_PIN       D3
+#define DS1302_CE1_PIN      D2
+#define DS1302_CE2_PIN      D1
+#elif defined(ARDUINO_ARCH_ESP32)
+#define DS1302_CLK_PIN      0
+#define DS1302_IO_PIN       4
+#define DS1302_CE1_PIN      5
+#define DS1302_CE2_PIN      16
+#else
+#error #error "May work, but not tested on this target"
+#endif
+
+// Create bus which owns the CLK and IO pins
+ErriezDS1302Bus bus = ErriezDS1302Bus(DS1302_CLK_PIN, DS1302_IO_PIN);
+
+// Create a DS1302 RTC object per CE pin
+ErriezDS1302 rtc1 = ErriezDS1302(&bus, DS1302_CE1_PIN);
+ErriezDS1302 rtc2 = ErriezDS1302(&bus, DS1302_CE2_PIN);
+
+
+void setup()
+{
+    // Initialize serial port
+    delay(500);
+    Serial.begin(115200);
+    while (!Serial) {
+        ;
+    }
+    Serial.println(F("\nErriez DS1302 RTC shared bus example\n"));
+
+    // Drive all CE pins low before the first transfer
+    bus.attach(&rtc1);
+    bus.attach(&rtc2);
+
+    // Initialize RTC's
+    while (!rtc1.begin()) {
+        Serial.println(F("RTC 1 not found"));
+        delay(3000);
+    }
+    while (!rtc2.begin()) {
+        Serial.println(F("RTC 2 not found"));
+        delay(3000);
+    }
+
+    // Enable RTC clocks
+    rtc1.clockEnable(true);
+    rtc2.clockEnable(true);
+}
+
+void loop()
+{
+    struct tm dt[2];
+
+    // Read both clocks back-to-back
+    if (bus.readAll(dt) != bus.getNumDevices()) {
+        Serial.println(F("RTC read failed"));
+    }
+
+    Serial.print(F("RTC 1: "));
+    Serial.print(asctime(&dt[0]));
+    Serial.print(F("RTC 2: "));
+    Serial.print(asctime(&dt[1]));
+
+    // Wait some time
+    delay(1000);
+}
@@ -0,0 +1,155 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \brief DS1302 RTC delta compressed timestamp logging example for Arduino
+ * \details
+ *    Source:         https://github.com/Erriez/ErriezDS1302
+ *    Documentation:  https://erriez.github.io/ErriezDS1302
+ *
+ *    Samples are timestamped every 10ms with RTC wall-clock time and milliseconds. The encoded
+ *    timestamps are collected in a block which is printed as hex, where a logger would write
+ *    the block to SD or flash. Decode the log on a host with
+ *    examples/Linux/ErriezDS1302TimeLog.
+ */
+
+#include <ErriezDS1302.h>
+#include <ErriezDS1302EventStamp.h>
+#include <ErriezDS1302TimeLog.h>
+
+// Connect DS1302 data pin to Arduino DIGITAL pin
+#if defined(ARDUINO_ARCH_AVR)
+#define DS1302_CLK_PIN      2
+#define DS1302_IO_PIN       3
+#define DS1302_CE_PIN       4
+#elif defined(ARDUINO_ARCH_ESP8266)
+// Swap D2 and D4 pins for the ESP8266, because pin D2 is high during a
+// power-on / MCU reset / and flashing. This corrupts RTC registers.
+#define DS1302_CLK_PIN      D4 // Pin is high during power-on / reset / flashing
+#define DS1302_IO_PIN       D3
+#define DS1302_CE_PIN       D2
+#elif defined(ARDUINO_ARCH_ESP32)
+#define DS1302_CLK_PIN      0
+#define DS1302_IO_PIN       4
+#define DS1302_CE_PIN       5
+#else
+#error #error "May work, but not tested on this target"
+#endif
+
+// Sample interval in ms
+#define SAMPLE_INTERVAL_MS  10
+
+// Log block size, for example an SD card sector
+#define BLOCK_SIZE          128
+
+// Create DS1302 RTC object
+ErriezDS1302 rtc = ErriezDS1302(DS1302_CLK_PIN, DS1302_IO_PIN, DS1302_CE_PIN);
+
+// Create millisecond time source
+ErriezDS1302EventStamp events = ErriezDS1302EventStamp(&rtc);
+
+// Create timestamp encoder with millisecond resolution
+ErriezDS1302TimeLogEncoder encoder = ErriezDS1302TimeLogEncoder(true);
+
+uint8_t block[BLOCK_SIZE];
+uint8_t blockLen;
+uint16_t numSamples;
+
+
+void writeBlock()
+{
+    char hex[3];
+
+    // Replace with SD card or flash write
+    for (uint8_t i = 0; i < blockLen; i++) {
+        snprintf(hex, sizeof(hex), "%02X", block[i]);
+        Serial.print(hex);
+    }
+    Serial.println();
+
+    Serial.print(numSamples);
+    Serial.print(F(" timestamps in "));
+    Serial.print(blockLen);
+    Serial.print(F(" Bytes, "));
+    Serial.print(numSamples * sizeof(uint32_t));
+    Serial.println(F(" Bytes as 32-bit epoch"));
+
+    blockLen = 0;
+    numSamples = 0;
+
+    // Start every block with a reference, so blocks can be decoded independently
+    encoder.reset();
+}
+
+void setup()
+{
+    // Initialize serial port
+    delay(500);
+    Serial.begin(115200);
+    while (!Serial) {
+        ;
+    }
+    Serial.println(F("\nErriez DS1302 RTC timestamp log example\n"));
+
+    // Initialize RTC
+    while (!rtc.begin()) {
+        Serial.println(F("RTC not found"));
+        delay(3000);
+    }
+
+    // Enable RTC clock
+    rtc.clockEnable(true);
+
+    // Wait for a seconds change
+    while (!events.sync()) {
+        Serial.println(F("RTC not running"));
+    }
+}
+
+void loop()
+{
+    uint8_t record[DS1302_TIMELOG_MAX_RECORD];
+    uint8_t len;
+    time_t t;
+    uint16_t ms;
+
+    // Keep the anchor at the RTC seconds change
+    events.update();
+
+    // Timestamp sample
+    if (!events.now(&t, &ms)) {
+        return;
+    }
+    len = encoder.encode(t, ms, record);
+
+    if ((blockLen + len) > BLOCK_SIZE) {
+        writeBlock();
+        len = encoder.encode(t, ms, record);
+    }
+    memcpy(&block[blockLen], record, len);
+    blockLen += len;
+    numSamples++;
+
+    delay(SAMPLE_INTERVAL_MS);
+}
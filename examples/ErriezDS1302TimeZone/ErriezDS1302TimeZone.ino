@@ -0,0 +1,106 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \brief DS1302 RTC local time zone example for Arduino
+ * \details
+ *    Source:         https://github.com/Erriez/ErriezDS1302
+ *    Documentation:  https://erriez.github.io/ErriezDS1302
+ *
+ *    The RTC runs in UTC and is displayed in local time with a POSIX TZ rule.
+ */
+
+#include <ErriezDS1302.h>
+#include <ErriezDS1302TimeZone.h>
+
+// Connect DS1302 data pin to Arduino DIGITAL pin
+#if defined(ARDUINO_ARCH_AVR)
+#define DS1302_CLK_PIN      2
+#define DS1302_IO_PIN       3
+#define DS1302_CE_PIN       4
+#elif defined(ARDUINO_ARCH_ESP8266)
+// Swap D2 and D4 pins for the ESP8266, because pin D2 is high during a
+// power-on / MCU reset / and flashing. This corrupts RTC registers.
+#define DS1302_CLK_PIN      D4 // Pin is high during power-on / reset / flashing
+#define DS1302_IO_PIN       D3
+#define DS1302_CE_PIN       D2
+#elif defined(ARDUINO_ARCH_ESP32)
+#define DS1302_CLK_PIN      0
+#define DS1302_IO_PIN       4
+#define DS1302_CE_PIN       5
+#else
+#error #error "May work, but not tested on this target"
+#endif
+
+// Central European Time: UTC+1, DST UTC+2 from last Sunday of March 02:00 to last Sunday of
+// October 03:00
+#define TZ_RULE     "CET-1CEST,M3.5.0,M10.5.0/3"
+
+// Create DS1302 RTC object
+ErriezDS1302 rtc = ErriezDS1302(DS1302_CLK_PIN, DS1302_IO_PIN, DS1302_CE_PIN);
+
+// Create time zone object
+ErriezDS1302TimeZone tz = ErriezDS1302TimeZone(&rtc);
+
+
+void setup()
+{
+    // Initialize serial port
+    delay(500);
+    Serial.begin(115200);
+    while (!Serial) {
+        ;
+    }
+    Serial.println(F("\nErriez DS1302 RTC time zone example\n"));
+
+    // Initialize RTC
+    while (!rtc.begin()) {
+        Serial.println(F("RTC not found"));
+        delay(3000);
+    }
+
+    // Calculate DST transitions
+    if (!tz.begin(TZ_RULE, 2020)) {
+        Serial.println(F("Invalid TZ rule"));
+    }
+
+    // Enable RTC clock
+    rtc.clockEnable(true);
+}
+
+void loop()
+{
+    struct tm dt;
+
+    // Read UTC from RTC and convert to local time
+    if (!tz.getLocal(&dt)) {
+        Serial.println(F("RTC read failed"));
+    } else {
+        Serial.print(dt.tm_isdst ? F("CEST ") : F("CET  "));
+        Serial.print(asctime(&dt));
+    }
+
+    // Wait some time
+    delay(1000);
+}
@@ -0,0 +1,147 @@
+#
+# MIT License
+#
+# Copyright (c) 2020 Erriez
+#
+# Permission is hereby granted, free of charge, to any person obtaining a copy
+# of this software and associated documentation files (the "Software"), to deal
+# in the Software without restriction, including without limitation the rights
+# to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+# copies of the Software, and to permit persons to whom the Software is
+# furnished to do so, subject to the following conditions:
+#
+# The above copyright notice and this permission notice shall be included in all
+# copies or substantial portions of the Software.
+#
+# THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+# IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+# FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+# AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+# LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+# OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+# SOFTWARE.
+#
+# Source:         https://github.com/Erriez/ErriezDS1302
+# Documentation:  https://erriez.github.io/ErriezDS1302
+#
+# DS1302 bus transaction trace decoder
+#
+# Decodes the output of ErriezDS1302::dumpTrace() (library built with -DDS1302_TRACE) into
+# annotated transactions and transfer latency statistics per command. Other lines in the log,
+# for example from the sketch, are ignored.
+#
+# Usage:
+#   python3 ErriezDS1302Trace.py [-q] [trace.log]     (default: stdin)
+#
+
+import argparse
+import re
+import sys
+
+TRACE_LINE = re.compile(r'DS1302 (\d+) (\d+) ([0-9A-F]{2}) (\d+) ([0-9A-F]*)\s*$')
+
+CLOCK_REGS = ['seconds', 'minutes', 'hours', 'date', 'month', 'day', 'year', 'WP', 'TC']
+
+
+def bcd(value):
+    return (value >> 4) * 10 + (value & 0x0F)
+
+
+def command_name(cmd):
+    if not cmd & 0x80:
+        return 'invalid command'
+
+    direction = 'read' if cmd & 0x01 else 'write'
+    addr = (cmd >> 1) & 0x1F
+
+    if cmd & 0x40:
+        if addr == 31:
+            return '{} RAM burst'.format(direction)
+        return '{} RAM 0x{:02X}'.format(direction, addr)
+
+    if addr == 31:
+        return '{} clock burst'.format(direction)
+    if addr < len(CLOCK_REGS):
+        return '{} {}'.format(direction, CLOCK_REGS[addr])
+    return '{} clock 0x{:02X}'.format(direction, addr)
+
+
+def annotate(cmd, data):
+    if cmd & 0x40:
+        return ''
+
+    addr = (cmd >> 1) & 0x1F
+    if addr == 31 and len(data) >= 7:
+        text = '20{:02d}-{:02d}-{:02d} {:02d}:{:02d}:{:02d} wday={}'.format(
+            bcd(data[6]), bcd(data[4] & 0x1F), bcd(data[3] & 0x3F),
+            bcd(data[2] & 0x3F), bcd(data[1] & 0x7F), bcd(data[0] & 0x7F), data[5] & 0x07)
+        if data[0] & 0x80:
+            text += ' CH'
+        if len(data) >= 8 and data[7] & 0x80:
+            text += ' WP'
+        return text
+    if addr == 0 and data:
+        return 'CH' if data[0] & 0x80 else ''
+    if addr == 7 and data:
+        return 'WP' if data[0] & 0x80 else ''
+    return ''
+
+
+def percentile(values, p):
+    # Nearest rank
+    values = sorted(values)
+    rank = max(1, -(-len(values) * p // 100))
+    return values[rank - 1]
+
+
+def main():
+    parser = argparse.ArgumentParser(description='DS1302 bus transaction trace decoder')
+    parser.add_argument('log', nargs='?', help='Trace log, default stdin')
+    parser.add_argument('-q', '--quiet', action='store_true', help='Statistics only')
+    args = parser.parse_args()
+
+    stream = open(args.log) if args.log else sys.stdin
+    durations = {}
+
+    if not args.quiet:
+        print('{:>10} {:>7}  {:<2} {:<17} {:>3}  {}'.format(
+            'Start us', 'Dur us', 'Cmd', 'Transaction', 'Len', 'Data'))
+
+    for line in stream:
+        match = TRACE_LINE.search(line)
+        if not match:
+            continue
+
+        start = int(match.group(1))
+        duration = int(match.group(2))
+        cmd = int(match.group(3), 16)
+        length = int(match.group(4))
+        data = bytes.fromhex(match.group(5))
+        name = command_name(cmd)
+
+        durations.setdefault(name, []).append(duration)
+
+        if not args.quiet:
+            data_text = data.hex().upper()
+            if length > len(data):
+                data_text += '... ({} stored)'.format(len(data))
+            print('{:>10} {:>7}  {:02X} {:<17} {:>3}  {}  {}'.format(
+                start, duration, cmd, name, length, data_text, annotate(cmd, data)))
+
+    if not durations:
+        print('No trace records found')
+        return 1
+
+    print()
+    print('{:<17} {:>7} {:>7} {:>7} {:>7}'.format('Transaction', 'Count', 'p50 us', 'p99 us',
+                                                   'Max us'))
+    for name in sorted(durations):
+        values = durations[name]
+        print('{:<17} {:>7} {:>7} {:>7} {:>7}'.format(
+            name, len(values), percentile(values, 50), percentile(values, 99), max(values)))
+
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
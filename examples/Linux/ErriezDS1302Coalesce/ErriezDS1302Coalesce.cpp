@@ -0,0 +1,181 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \brief DS1302 RTC request coalescing test with threads and a simulated chip
+ * \details
+ *    Source:         https://github.com/Erriez/ErriezDS1302
+ *    Documentation:  https://erriez.github.io/ErriezDS1302
+ *
+ *    Every simulated second all threads read the RTC at the same moment, like FreeRTOS tasks
+ *    on an ESP32. The simulator blocks the calling thread during each transfer as long as the
+ *    transfer takes with ESP32 pin timing. Reports the bus transfers saved by coalescing and
+ *    returns a non-zero exit code when a thread reads a wrong time. A read served from cache
+ *    may be behind by the freshness window, so with -f a simulated second lasts -p ms.
+ *
+ *    Build on the host:
+ *      g++ -O2 -pthread -DDS1302_SIMULATOR -Isrc src/ErriezDS1302*.cpp \
+ *          examples/Linux/ErriezDS1302Coalesce/ErriezDS1302Coalesce.cpp -o ds1302-coalesce
+ *
+ *    Run:
+ *      ./ds1302-coalesce [-t threads] [-n seconds] [-f freshness ms] [-p period ms]
+ *                        [-w write interval seconds]
+ */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <ErriezDS1302.h>
+#include <ErriezDS1302Coalesce.h>
+#include <ErriezDS1302TimeZone.h>
+
+//! Maximum number of threads
+#define MAX_THREADS     64
+
+//! Start time of the test
+#define START_EPOCH     1600000000L
+
+static ErriezDS1302Sim sim;                     //!< Simulated chip
+static ErriezDS1302 rtc(&sim);                  //!< RTC on the simulated chip
+static ErriezDS1302Coalesce coalesce(&rtc);     //!< Coalescing front-end
+
+static pthread_barrier_t barrier;               //!< Start of every simulated second
+static unsigned long numSeconds = 1000;         //!< Number of simulated seconds
+static unsigned long writeInterval = 0;         //!< Write interval in seconds, 0 = no writes
+static unsigned long periodMs = 0;              //!< Real duration of a simulated second
+static unsigned long maxStale = 0;              //!< Allowed seconds behind due to the cache
+static volatile unsigned long errors;           //!< Wrong times read
+
+/*!
+ * \brief Task reading the RTC every second
+ * \param arg
+ *      Thread index.
+ * \return
+ *      NULL.
+ */
+static void *task(void *arg)
+{
+    long index = (long)arg;
+
+    for (unsigned long second = 0; second < numSeconds; second++) {
+        // Thread 0 advances the chip while no thread accesses the bus
+        pthread_barrier_wait(&barrier);
+        if ((index == 0) && (second != 0)) {
+            usleep(periodMs * 1000);
+            sim.advance(1);
+        }
+        pthread_barrier_wait(&barrier);
+
+        if ((index == 0) && writeInterval && ((second % writeInterval) == 0)) {
+            // Write the current time, it has priority over reads not yet on the bus
+            coalesce.setEpoch(START_EPOCH + second);
+        }
+
+        time_t t = coalesce.getEpoch();
+        if ((t > (time_t)(START_EPOCH + second)) ||
+            (t < (time_t)(START_EPOCH + second - maxStale))) {
+            __atomic_add_fetch(&errors, 1, __ATOMIC_RELAXED);
+        }
+    }
+
+    return NULL;
+}
+
+int main(int argc, char *argv[])
+{
+    pthread_t threads[MAX_THREADS];
+    DS1302CoalesceMetrics metrics;
+    unsigned long numThreads = 6;
+    uint32_t freshnessMs = 0;
+    uint32_t busTransfers;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "t:n:f:p:w:")) != -1) {
+        switch (opt) {
+            case 't':
+                numThreads = strtoul(optarg, NULL, 0);
+                break;
+            case 'n':
+                numSeconds = strtoul(optarg, NULL, 0);
+                break;
+            case 'f':
+                freshnessMs = strtoul(optarg, NULL, 0);
+                break;
+            case 'p':
+                periodMs = strtoul(optarg, NULL, 0);
+                break;
+            case 'w':
+                writeInterval = strtoul(optarg, NULL, 0);
+                break;
+            default:
+                fprintf(stderr, "Usage: %s [-t threads] [-n seconds] [-f freshness ms] "
+                                "[-p period ms] [-w write interval]\n", argv[0]);
+                return 1;
+        }
+    }
+    if ((numThreads < 1) || (numThreads > MAX_THREADS)) {
+        fprintf(stderr, "Number of threads 1..%d\n", MAX_THREADS);
+        return 1;
+    }
+
+    // Cached reads are at most the freshness window behind, plus the second in progress
+    if (freshnessMs) {
+        maxStale = periodMs ? ((freshnessMs + periodMs - 1) / periodMs) : numSeconds;
+    }
+
+    // ESP32 pin access time, DS1302_PIN_DELAY() is delayMicroseconds(1)
+    sim.setTiming(300, 300, 300, 1000);
+    if (!rtc.begin() || !rtc.setEpoch(START_EPOCH)) {
+        fprintf(stderr, "RTC not found\n");
+        return 1;
+    }
+    sim.resetStats();
+    sim.setRealTime(true);
+    coalesce.setFreshness(freshnessMs);
+
+    pthread_barrier_init(&barrier, NULL, numThreads);
+    for (unsigned long i = 0; i < numThreads; i++) {
+        pthread_create(&threads[i], NULL, task, (void *)i);
+    }
+    for (unsigned long i = 0; i < numThreads; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    pthread_barrier_destroy(&barrier);
+
+    coalesce.getMetrics(&metrics);
+    busTransfers = sim.getPhase(DS1302_SIM_TCWH)->samples;
+
+    printf("Threads:                %lu\n", numThreads);
+    printf("Requests:               %u (%u writes)\n", metrics.requests, metrics.writes);
+    printf("Bus transfers:          %u (simulator: %u)\n", metrics.transfers, busTransfers);
+    printf("Coalesced reads:        %u\n", metrics.coalesced);
+    printf("Cache hits:             %u\n", metrics.cacheHits);
+    printf("Transfers saved:        %.1f%%\n",
+           metrics.requests ? 100.0 * (metrics.requests - metrics.transfers) / metrics.requests : 0);
+    printf("Wrong times:            %lu\n", errors);
+    printf("Timing violations:      %u\n", sim.getViolations());
+
+    return (errors || sim.getViolations()) ? 1 : 0;
+}
@@ -0,0 +1,563 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \brief DS1302 RTC Linux GPIO backend test with a userspace DS1302 responder
+ * \details
+ *    Source:         https://github.com/Erriez/ErriezDS1302
+ *    Documentation:  https://erriez.github.io/ErriezDS1302
+ *
+ *    Runs the Linux GPIO character device backend against a userspace responder instead of a
+ *    kernel GPIO chip. The GPIO v2 line request ioctls of the backend are intercepted with the
+ *    linker and executed on the simulated DS1302 chip model, with every ioctl taking -t ns.
+ *    Lines changed by one ioctl change at the same moment, as with a multi-line register write.
+ *
+ *    Checks register and RAM read/write, datasheet timing of every edge, the kernel rules of
+ *    the uAPI (no values written to input lines), the ioctl count per byte and per transfer,
+ *    and failed ioctls reported by begin() and the transfers. Returns a non-zero exit code on
+ *    an error.
+ *
+ *    Build on a Linux host:
+ *      g++ -O2 -Isrc src/ErriezDS1302*.cpp \
+ *          examples/Linux/ErriezDS1302GpioResponder/ErriezDS1302GpioResponder.cpp \
+ *          -Wl,--wrap=ioctl -o ds1302-gpio-responder
+ *
+ *    Run:
+ *      ./ds1302-gpio-responder [-t ioctl ns] [-l (VCC 2.0V limits)] [-v trace.vcd]
+ *
+ *    The library adds no delays on Linux: with VCC 2.0V limits, CE setup and inactive time
+ *    (tCC, tCWH) require ioctls of at least 4 us (-l -t 4000).
+ */
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <linux/gpio.h>
+#include <ErriezDS1302.h>
+#include <ErriezDS1302Sim.h>
+
+#ifndef DS1302_LINUX_GPIO
+#error "Build for Linux without -DDS1302_SIMULATOR"
+#endif
+
+//! Number of requested lines
+#define NUM_LINES           3
+
+//! ioctls per data bit
+#define WRITE_BIT_IOCTLS    2       //!< Falling edge with data, rising edge
+#define READ_BIT_IOCTLS     3       //!< Rising edge, falling edge, IO read
+
+extern "C" int __real_ioctl(int fd, unsigned long request, ...);
+
+//! Userspace DS1302 responder on the GPIO v2 line request uAPI
+struct Responder {
+    ErriezDS1302Sim sim;            //!< Simulated chip
+    uint32_t ioctlNs;               //!< Duration of an ioctl
+    int lineFd;                     //!< Line request file descriptor
+    uint8_t pins[NUM_LINES];        //!< Simulator pin per line index
+    bool output[NUM_LINES];         //!< Line is output
+    bool value[NUM_LINES];          //!< Output level
+    uint32_t ioctls;                //!< Number of GPIO ioctls
+    uint32_t uapiErrors;            //!< Requests the kernel would reject
+    bool failGetLine;               //!< Fail the next line request
+    uint32_t setValuesIoctls;       //!< Number of GPIO_V2_LINE_SET_VALUES_IOCTL
+    uint32_t failSetValues;         //!< Fail the Nth next GPIO_V2_LINE_SET_VALUES_IOCTL, 0=none
+};
+
+static Responder responder;         //!< Responder instance
+
+/*!
+ * \brief Drive lines of one ioctl at the same moment
+ * \param output
+ *      New line directions.
+ * \param value
+ *      New output levels.
+ */
+static void applyLines(const bool *output, const bool *value)
+{
+    // Lines are changed in line index order, like gpiolib
+    for (uint8_t i = 0; i < NUM_LINES; i++) {
+        if (output[i] != responder.output[i]) {
+            responder.output[i] = output[i];
+            responder.sim.pinMode(responder.pins[i], !output[i]);
+        }
+        if (output[i] && (value[i] != responder.value[i])) {
+            responder.value[i] = value[i];
+            responder.sim.pinWrite(responder.pins[i], value[i]);
+        }
+    }
+}
+
+/*!
+ * \brief GPIO_V2_GET_LINE_IOCTL
+ * \param req
+ *      Line request.
+ * \return
+ *      0 on success, -1 with errno on error.
+ */
+static int getLine(struct gpio_v2_line_request *req)
+{
+    bool output[NUM_LINES];
+    bool value[NUM_LINES];
+
+    if (responder.failGetLine) {
+        responder.failGetLine = false;
+        errno = EBUSY;
+        return -1;
+    }
+    if ((req->num_lines != NUM_LINES) || (req->config.flags != GPIO_V2_LINE_FLAG_OUTPUT)) {
+        responder.uapiErrors++;
+        errno = EINVAL;
+        return -1;
+    }
+
+    for (uint8_t i = 0; i < NUM_LINES; i++) {
+        if (req->offsets[i] >= NUM_LINES) {
+            errno = EINVAL;
+            return -1;
+        }
+        responder.pins[i] = (uint8_t)req->offsets[i];
+        output[i] = true;
+        value[i] = false;
+    }
+    for (uint32_t a = 0; a < req->config.num_attrs; a++) {
+        if (req->config.attrs[a].attr.id == GPIO_V2_LINE_ATTR_ID_OUTPUT_VALUES) {
+            for (uint8_t i = 0; i < NUM_LINES; i++) {
+                if (req->config.attrs[a].mask & (1ULL << i)) {
+                    value[i] = (req->config.attrs[a].attr.values >> i) & 1;
+                }
+            }
+        }
+    }
+    applyLines(output, value);
+
+    responder.lineFd = open("/dev/null", O_RDONLY | O_CLOEXEC);
+    req->fd = responder.lineFd;
+
+    return 0;
+}
+
+/*!
+ * \brief GPIO_V2_LINE_SET_CONFIG_IOCTL
+ * \param config
+ *      Line configuration.
+ * \return
+ *      0 on success, -1 with errno on error.
+ */
+static int setConfig(struct gpio_v2_line_config *config)
+{
+    bool output[NUM_LINES];
+    bool value[NUM_LINES];
+    uint64_t flags[NUM_LINES];
+
+    for (uint8_t i = 0; i < NUM_LINES; i++) {
+        flags[i] = config->flags;
+        value[i] = false;
+    }
+    for (uint32_t a = 0; a < config->num_attrs; a++) {
+        for (uint8_t i = 0; i < NUM_LINES; i++) {
+            if (!(config->attrs[a].mask & (1ULL << i))) {
+                continue;
+            }
+            if (config->attrs[a].attr.id == GPIO_V2_LINE_ATTR_ID_FLAGS) {
+                flags[i] = config->attrs[a].attr.flags;
+            } else if (config->attrs[a].attr.id == GPIO_V2_LINE_ATTR_ID_OUTPUT_VALUES) {
+                value[i] = (config->attrs[a].attr.values >> i) & 1;
+            }
+        }
+    }
+    for (uint8_t i = 0; i < NUM_LINES; i++) {
+        if (!(flags[i] & (GPIO_V2_LINE_FLAG_INPUT | GPIO_V2_LINE_FLAG_OUTPUT))) {
+            responder.uapiErrors++;
+            errno = EINVAL;
+            return -1;
+        }
+        output[i] = (flags[i] & GPIO_V2_LINE_FLAG_OUTPUT) ? true : false;
+    }
+    applyLines(output, value);
+
+    return 0;
+}
+
+/*!
+ * \brief GPIO_V2_LINE_SET_VALUES_IOCTL
+ * \param values
+ *      Line values.
+ * \return
+ *      0 on success, -1 with errno on error.
+ */
+static int setValues(struct gpio_v2_line_values *values)
+{
+    bool value[NUM_LINES];
+
+    responder.setValuesIoctls++;
+    if (responder.failSetValues && (--responder.failSetValues == 0)) {
+        errno = EIO;
+        return -1;
+    }
+
+    for (uint8_t i = 0; i < NUM_LINES; i++) {
+        value[i] = responder.value[i];
+        if (values->mask & (1ULL << i)) {
+            if (!responder.output[i]) {
+                // gpiolib refuses values for input lines
+                responder.uapiErrors++;
+                errno = EPERM;
+                return -1;
+            }
+            value[i] = (values->bits >> i) & 1;
+        }
+    }
+    applyLines(responder.output, value);
+
+    return 0;
+}
+
+/*!
+ * \brief GPIO_V2_LINE_GET_VALUES_IOCTL
+ * \param values
+ *      Line values.
+ * \return
+ *      0.
+ */
+static int getValues(struct gpio_v2_line_values *values)
+{
+    uint64_t bits = 0;
+
+    for (uint8_t i = 0; i < NUM_LINES; i++) {
+        if (!(values->mask & (1ULL << i))) {
+            continue;
+        }
+        if (responder.output[i] ? responder.value[i] :
+                                  ((responder.pins[i] == DS1302_SIM_IO) && responder.sim.pinRead())) {
+            bits |= (1ULL << i);
+        }
+    }
+    values->bits = bits;
+
+    return 0;
+}
+
+/*!
+ * \brief ioctl() of the library, GPIO requests are executed by the responder
+ * \param fd
+ *      File descriptor.
+ * \param request
+ *      Request code.
+ * \return
+ *      ioctl() result.
+ */
+extern "C" int __wrap_ioctl(int fd, unsigned long request, ...)
+{
+    va_list args;
+    void *arg;
+
+    va_start(args, request);
+    arg = va_arg(args, void *);
+    va_end(args);
+
+    if (request == GPIO_V2_GET_LINE_IOCTL) {
+        responder.ioctls++;
+        responder.sim.pinDelay();
+        return getLine((struct gpio_v2_line_request *)arg);
+    }
+    if ((responder.lineFd < 0) || (fd != responder.lineFd)) {
+        return __real_ioctl(fd, request, arg);
+    }
+
+    responder.ioctls++;
+    responder.sim.pinDelay();
+
+    switch (request) {
+        case GPIO_V2_LINE_SET_CONFIG_IOCTL:
+            return setConfig((struct gpio_v2_line_config *)arg);
+        case GPIO_V2_LINE_SET_VALUES_IOCTL:
+            return setValues((struct gpio_v2_line_values *)arg);
+        case GPIO_V2_LINE_GET_VALUES_IOCTL:
+            return getValues((struct gpio_v2_line_values *)arg);
+        default:
+            responder.uapiErrors++;
+            errno = ENOTTY;
+            return -1;
+    }
+}
+
+/*!
+ * \brief Print check result
+ * \param name
+ *      Check name.
+ * \param ok
+ *      Result.
+ * \return
+ *      0 when passed, 1 when failed.
+ */
+static int check(const char *name, bool ok)
+{
+    printf("%-44s %s\n", name, ok ? "OK" : "FAIL");
+
+    return ok ? 0 : 1;
+}
+
+/*!
+ * \brief Register and RAM read/write through the backend
+ * \param rtc
+ *      RTC on the responder.
+ * \return
+ *      Number of failed checks.
+ */
+static int testReadWrite(ErriezDS1302 *rtc)
+{
+    uint8_t clock[DS1302_NUM_CLOCK_REGS + 1] = { 0x56, 0x34, 0x12, 0x31, 0x12, 0x05, 0x99, 0x00 };
+    uint8_t buf[DS1302_NUM_RAM_REGS];
+    bool ok;
+    int errors = 0;
+
+    // Single registers
+    ok = rtc->writeRegister(DS1302_REG_MINUTES, 0x42) &&
+         (responder.sim.getRegister(DS1302_REG_MINUTES) == 0x42);
+    errors += check("writeRegister()", ok);
+    responder.sim.setRegister(DS1302_REG_HOURS, 0x17);
+    errors += check("readRegister()", rtc->readRegister(DS1302_REG_HOURS) == 0x17);
+
+    // Clock burst
+    ok = rtc->writeBuffer(0x00, clock, sizeof(clock));
+    for (uint8_t i = 0; i < sizeof(clock); i++) {
+        ok &= (responder.sim.getRegister(i) == clock[i]);
+    }
+    errors += check("writeBuffer() clock burst", ok);
+    memset(buf, 0, sizeof(buf));
+    ok = rtc->readBuffer(0x00, buf, sizeof(clock)) && !memcmp(buf, clock, sizeof(clock));
+    errors += check("readBuffer() clock burst", ok);
+
+    // RAM, all bit patterns on the bus
+    ok = true;
+    for (uint16_t i = 0; i < 256; i++) {
+        rtc->writeByteRAM(i % DS1302_NUM_RAM_REGS, (uint8_t)i);
+        ok &= (responder.sim.getRAM(i % DS1302_NUM_RAM_REGS) == i);
+        responder.sim.setRAM(i % DS1302_NUM_RAM_REGS, (uint8_t)~i);
+        ok &= (rtc->readByteRAM(i % DS1302_NUM_RAM_REGS) == (uint8_t)~i);
+    }
+    errors += check("writeByteRAM() / readByteRAM()", ok);
+
+    for (uint8_t i = 0; i < DS1302_NUM_RAM_REGS; i++) {
+        buf[i] = (uint8_t)(i * 37 + 11);
+    }
+    rtc->writeBufferRAM(buf, DS1302_NUM_RAM_REGS);
+    ok = true;
+    for (uint8_t i = 0; i < DS1302_NUM_RAM_REGS; i++) {
+        ok &= (responder.sim.getRAM(i) == buf[i]);
+    }
+    errors += check("writeBufferRAM() burst", ok);
+    memset(buf, 0, sizeof(buf));
+    rtc->readBufferRAM(buf, DS1302_NUM_RAM_REGS);
+    ok = true;
+    for (uint8_t i = 0; i < DS1302_NUM_RAM_REGS; i++) {
+        ok &= (buf[i] == (uint8_t)(i * 37 + 11));
+    }
+    errors += check("readBufferRAM() burst", ok);
+
+    return errors;
+}
+
+/*!
+ * \brief ioctl count per byte and per transfer
+ * \param rtc
+ *      RTC on the responder.
+ * \return
+ *      Number of failed checks.
+ */
+static int testSyscalls(ErriezDS1302 *rtc)
+{
+    uint8_t buf[DS1302_NUM_RAM_REGS];
+    uint32_t write1, write31, read1, read31;
+    uint32_t start;
+    int errors = 0;
+
+    memset(buf, 0x5A, sizeof(buf));
+
+    rtc->writeBufferRAM(buf, 1);
+    write1 = rtc->getTransferSyscallCount();
+    rtc->writeBufferRAM(buf, DS1302_NUM_RAM_REGS);
+    write31 = rtc->getTransferSyscallCount();
+    rtc->readBufferRAM(buf, 1);
+    read1 = rtc->getTransferSyscallCount();
+    rtc->readBufferRAM(buf, DS1302_NUM_RAM_REGS);
+    read31 = rtc->getTransferSyscallCount();
+
+    printf("\nioctls per transfer:\n");
+    printf("  writeRegister()         ");
+    rtc->writeRegister(DS1302_REG_MINUTES, 0x00);
+    printf("%3u\n", rtc->getTransferSyscallCount());
+    printf("  readRegister()          ");
+    rtc->readRegister(DS1302_REG_MINUTES);
+    printf("%3u\n", rtc->getTransferSyscallCount());
+    printf("  readBuffer() 8 bytes    ");
+    rtc->readBuffer(0x00, buf, DS1302_NUM_CLOCK_REGS + 1);
+    printf("%3u\n", rtc->getTransferSyscallCount());
+    printf("  writeBufferRAM() 31     %3u\n", write31);
+    printf("  readBufferRAM() 31      %3u\n", read31);
+    printf("ioctls per data byte:     write %u, read %u\n\n",
+           (write31 - write1) / (DS1302_NUM_RAM_REGS - 1),
+           (read31 - read1) / (DS1302_NUM_RAM_REGS - 1));
+
+    errors += check("Write ioctls per byte",
+                    (write31 - write1) == (DS1302_NUM_RAM_REGS - 1) * 8 * WRITE_BIT_IOCTLS);
+    errors += check("Read ioctls per byte",
+                    (read31 - read1) == (DS1302_NUM_RAM_REGS - 1) * 8 * READ_BIT_IOCTLS);
+
+    // CE edges cost one ioctl each, the IO turnaround is written with the first falling edge
+    // of the data
+    errors += check("Read transfer overhead",
+                    read1 == 1 + (8 * WRITE_BIT_IOCTLS) + (8 * READ_BIT_IOCTLS - 1) + 1);
+
+    start = responder.ioctls - rtc->getSyscallCount();
+    rtc->readRegister(DS1302_REG_SECONDS);
+    errors += check("getSyscallCount() matches responder",
+                    (responder.ioctls - rtc->getSyscallCount()) == start);
+
+    return errors;
+}
+
+/*!
+ * \brief Failed ioctls reported to the caller
+ * \param rtc
+ *      RTC on the responder.
+ * \return
+ *      Number of failed checks.
+ */
+static int testErrors(ErriezDS1302 *rtc)
+{
+    uint32_t seconds;
+    uint32_t start;
+    uint32_t writeIoctls;
+    uint32_t beginIoctls;
+    bool ok;
+    int errors = 0;
+
+    responder.failSetValues = 1;
+    errors += check("Failed ioctl: writeRegister() false",
+                    !rtc->writeRegister(DS1302_REG_MINUTES, 0x12));
+    responder.failSetValues = 1;
+    errors += check("Failed ioctl: readRegister() 0xFF",
+                    rtc->readRegister(DS1302_REG_DAY_WEEK) == 0xFF);
+    errors += check("Next transfer succeeds", rtc->writeRegister(DS1302_REG_MINUTES, 0x12));
+    responder.failSetValues = 1;
+    errors += check("Failed ioctl: getSecondsOfDay() false", !rtc->getSecondsOfDay(&seconds));
+
+    // Fail the first ioctl of the minutes write, the third register write of setTime()
+    start = responder.setValuesIoctls;
+    rtc->writeRegister(DS1302_REG_MINUTES, 0x12);
+    responder.failSetValues = 2 * (responder.setValuesIoctls - start) + 1;
+    errors += check("Failed ioctl: setTime() false", !rtc->setTime(12, 34, 56));
+    errors += check("setTime() stopped at the failed write",
+                    !responder.failSetValues && (rtc->readRegister(DS1302_REG_SECONDS) < 0x02));
+
+    // Fail the write protect write, the last transfer of beginFast()
+    rtc->writeRegister(DS1302_REG_WP, 0x80);
+    start = responder.setValuesIoctls;
+    rtc->writeRegister(DS1302_REG_WP, 0x80);
+    writeIoctls = responder.setValuesIoctls - start;
+    start = responder.setValuesIoctls;
+    ok = (rtc->beginFast() & DS1302_FAST_WP_CLEARED);
+    beginIoctls = responder.setValuesIoctls - start;
+    rtc->writeRegister(DS1302_REG_WP, 0x80);
+    // The write may start with SET_CONFIG after the burst read: fail its second SET_VALUES
+    responder.failSetValues = beginIoctls - writeIoctls + 2;
+    errors += check("Failed ioctl: beginFast() 0", ok && (rtc->beginFast() == 0));
+
+    responder.failSetValues = 1;
+    errors += check("Failed ioctl: begin() false", !rtc->begin());
+    responder.failGetLine = true;
+    errors += check("Failed line request: begin() false", !rtc->begin());
+
+    start = responder.ioctls;
+    ok = rtc->begin();
+    errors += check("begin() resets getSyscallCount()",
+                    ok && (rtc->getSyscallCount() == (responder.ioctls - start)));
+
+    return errors;
+}
+
+int main(int argc, char *argv[])
+{
+    const char *vcdPath = NULL;
+    int errors = 0;
+    int opt;
+
+    responder.ioctlNs = 1000;
+    responder.lineFd = -1;
+    for (uint8_t i = 0; i < NUM_LINES; i++) {
+        responder.output[i] = true;
+    }
+
+    while ((opt = getopt(argc, argv, "t:lv:")) != -1) {
+        switch (opt) {
+            case 't':
+                responder.ioctlNs = strtoul(optarg, NULL, 0);
+                break;
+            case 'l':
+                responder.sim.setSupplyVoltage(true);
+                break;
+            case 'v':
+                vcdPath = optarg;
+                break;
+            default:
+                fprintf(stderr, "Usage: %s [-t ioctl ns] [-l] [-v file.vcd]\n", argv[0]);
+                return 1;
+        }
+    }
+
+    // Pin changes of one ioctl happen at the same moment, each ioctl takes ioctlNs
+    responder.sim.setTiming(0, 0, 0, responder.ioctlNs);
+    if (vcdPath && !responder.sim.openVcd(vcdPath)) {
+        fprintf(stderr, "Cannot create %s\n", vcdPath);
+        return 1;
+    }
+
+    // Any file works as GPIO chip, the line request is served by the responder
+    ErriezDS1302 rtc("/dev/null", DS1302_SIM_CLK, DS1302_SIM_IO, DS1302_SIM_CE);
+
+    errors += check("begin()", rtc.begin());
+    errors += testReadWrite(&rtc);
+    errors += testSyscalls(&rtc);
+    errors += check("Datasheet timing", responder.sim.getViolations() == 0);
+    errors += check("IO contentions", responder.sim.getContentions() == 0);
+    errors += check("Requests accepted by the GPIO uAPI", responder.uapiErrors == 0);
+    errors += testErrors(&rtc);
+
+    if (responder.sim.getViolations()) {
+        printf("\n");
+        responder.sim.printReport(stdout);
+    }
+    responder.sim.closeVcd();
+    rtc.end();
+
+    printf("\nErrors: %d\n", errors);
+
+    return errors ? 1 : 0;
+}
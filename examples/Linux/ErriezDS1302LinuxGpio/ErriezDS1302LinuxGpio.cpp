@@ -0,0 +1,98 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \brief DS1302 RTC Linux GPIO character device example
+ * \details
+ *    Source:         https://github.com/Erriez/ErriezDS1302
+ *    Documentation:  https://erriez.github.io/ErriezDS1302
+ *
+ *    Build on the Linux target:
+ *      g++ -O2 -Isrc src/ErriezDS1302*.cpp examples/Linux/ErriezDS1302LinuxGpio/ErriezDS1302LinuxGpio.cpp \
+ *          -o ds1302-gpio
+ *
+ *    Run:
+ *      ./ds1302-gpio [/dev/gpiochipN] [CLK line] [IO line] [CE line]
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <ErriezDS1302.h>
+
+int main(int argc, char *argv[])
+{
+    const char *chipPath = "/dev/gpiochip0";
+    uint8_t clkLine = 0;
+    uint8_t ioLine = 1;
+    uint8_t ceLine = 2;
+    uint8_t buf[DS1302_NUM_RAM_REGS];
+    struct tm dt;
+
+    if (argc > 1) {
+        chipPath = argv[1];
+    }
+    if (argc > 4) {
+        clkLine = (uint8_t)atoi(argv[2]);
+        ioLine = (uint8_t)atoi(argv[3]);
+        ceLine = (uint8_t)atoi(argv[4]);
+    }
+
+    // Create RTC object
+    ErriezDS1302 rtc(chipPath, clkLine, ioLine, ceLine);
+
+    // Initialize RTC
+    if (!rtc.begin()) {
+        fprintf(stderr, "RTC not found on %s lines %u %u %u\n", chipPath, clkLine, ioLine, ceLine);
+        return 1;
+    }
+    printf("rtc.begin(): %u ioctls\n", rtc.getSyscallCount());
+
+    // Read date/time
+    if (!rtc.read(&dt)) {
+        printf("rtc.read(): invalid date/time, %u ioctls\n", rtc.getTransferSyscallCount());
+    } else {
+        printf("rtc.read(): %s", asctime(&dt));
+        printf("rtc.read(): %u ioctls\n", rtc.getTransferSyscallCount());
+    }
+
+    // Read single register
+    rtc.readRegister(DS1302_REG_SECONDS);
+    printf("rtc.readRegister(): %u ioctls\n", rtc.getTransferSyscallCount());
+
+    // Write single register
+    rtc.writeRegister(DS1302_REG_WP, 0);
+    printf("rtc.writeRegister(): %u ioctls\n", rtc.getTransferSyscallCount());
+
+    // Read RAM
+    rtc.readBufferRAM(buf, sizeof(buf));
+    printf("rtc.readBufferRAM(): %u ioctls\n", rtc.getTransferSyscallCount());
+
+    // Write RAM
+    rtc.writeBufferRAM(buf, sizeof(buf));
+    printf("rtc.writeBufferRAM(): %u ioctls\n", rtc.getTransferSyscallCount());
+
+    printf("Total: %u ioctls\n", rtc.getSyscallCount());
+
+    return 0;
+}
@@ -0,0 +1,235 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \brief DS1302 RTC protocol timing verifier with simulated chip
+ * \details
+ *    Source:         https://github.com/Erriez/ErriezDS1302
+ *    Documentation:  https://erriez.github.io/ErriezDS1302
+ *
+ *    Runs the library against a simulated DS1302 with the pin timing of a target and checks
+ *    every edge against the datasheet. Returns a non-zero exit code on a timing violation or
+ *    data mismatch.
+ *
+ *    Build on the host:
+ *      g++ -O2 -DDS1302_SIMULATOR -Isrc src/ErriezDS1302*.cpp \
+ *          examples/Linux/ErriezDS1302Simulator/ErriezDS1302Simulator.cpp -o ds1302-sim
+ *
+ *    Run:
+ *      ./ds1302-sim [-w pin write ns] [-r pin read ns] [-m pin mode ns] [-d pin delay ns]
+ *                   [-l (VCC 2.0V limits)] [-s (search minimum pin delay)] [-v trace.vcd]
+ *
+ *    The defaults (-w 300 -r 300 -m 300 -d 1000) meet the 5.0V datasheet timing.
+ *
+ *    Add -DDS1302_TRACE to print the last bus transactions, decode them with
+ *    examples/ErriezDS1302Trace/ErriezDS1302Trace.py.
+ *
+ *    Example, AVR 16MHz port access of 2 cycles and DS1302_PIN_DELAY() removed:
+ *      ./ds1302-sim -w 125 -r 125 -m 125 -d 0
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <ErriezDS1302.h>
+
+//! Search limit for the minimum pin delay in ns
+#define MAX_PIN_DELAY_NS    100000UL
+
+//! Default pin write/read/mode time in ns
+#define DEFAULT_PIN_ACCESS_NS   300UL
+//! Default DS1302_PIN_DELAY() in ns
+#define DEFAULT_PIN_DELAY_NS    1000UL
+
+/*!
+ * \brief Run library functions against the simulated chip
+ * \param sim
+ *      Simulator.
+ * \return
+ *      Number of data mismatches.
+ */
+static int runWorkload(ErriezDS1302Sim *sim)
+{
+    ErriezDS1302 rtc(sim);
+    uint8_t buf[DS1302_NUM_RAM_REGS];
+    uint8_t check[DS1302_NUM_RAM_REGS];
+    uint8_t hour, min, sec;
+    struct tm dt;
+    struct tm rd;
+    int errors = 0;
+
+    if (!rtc.begin()) {
+        return 1;
+    }
+
+    // Date/time burst write and read
+    memset(&dt, 0, sizeof(dt));
+    dt.tm_hour = 23;
+    dt.tm_min = 59;
+    dt.tm_sec = 58;
+    dt.tm_mday = 31;
+    dt.tm_mon = 11;
+    dt.tm_year = 2099 - 1900;
+    dt.tm_wday = 4;
+    rtc.write(&dt);
+    if (!rtc.read(&rd) || (rd.tm_hour != dt.tm_hour) || (rd.tm_min != dt.tm_min) ||
+        (rd.tm_sec != dt.tm_sec) || (rd.tm_mday != dt.tm_mday) || (rd.tm_mon != dt.tm_mon) ||
+        (rd.tm_year != dt.tm_year) || (rd.tm_wday != dt.tm_wday)) {
+        errors++;
+    }
+
+    // Register access
+    rtc.setTime(12, 34, 56);
+    if (!rtc.getTime(&hour, &min, &sec) || (hour != 12) || (min != 34) || (sec != 56)) {
+        errors++;
+    }
+    if (!rtc.isRunning()) {
+        errors++;
+    }
+    if (!rtc.read(&rd) || (rd.tm_mday != 31) || (rd.tm_mon != 11) ||
+        (rd.tm_year != (2099 - 1900))) {
+        errors++;
+    }
+
+    // Field writes
+    rtc.setDate(29, 2, 2024, 4);
+    rtc.setField(DS1302_REG_MINUTES, 7);
+    if (!rtc.read(&rd) || (rd.tm_hour != 12) || (rd.tm_min != 7) || (rd.tm_mday != 29) ||
+        (rd.tm_mon != 1) || (rd.tm_year != (2024 - 1900)) || (rd.tm_wday != 4)) {
+        errors++;
+    }
+    if (rtc.setField(DS1302_REG_MONTH, 13) || rtc.setDate(1, 1, 2100, 0)) {
+        errors++;
+    }
+
+    // RAM byte and burst access
+    for (uint8_t i = 0; i < sizeof(buf); i++) {
+        buf[i] = (uint8_t)(0xA5 ^ (i * 37));
+    }
+    rtc.writeBufferRAM(buf, sizeof(buf));
+    rtc.readBufferRAM(check, sizeof(check));
+    if (memcmp(buf, check, sizeof(buf)) != 0) {
+        errors++;
+    }
+    rtc.writeByteRAM(0x1E, 0x5A);
+    if (rtc.readByteRAM(0x1E) != 0x5A) {
+        errors++;
+    }
+
+    // Fast start with warm-boot flag
+    rtc.writeByteRAM(0x00, DS1302_WARM_BOOT_MAGIC);
+    rtc.writeRegister(DS1302_REG_WP, 1 << DS1302_BIT_WP);
+    if (rtc.beginFast(&rd, 0x00) != (DS1302_FAST_PRESENT | DS1302_FAST_RUNNING |
+                                     DS1302_FAST_VALID | DS1302_FAST_WARM_BOOT |
+                                     DS1302_FAST_WP_CLEARED) || (rd.tm_mday != 29)) {
+        errors++;
+    }
+    rtc.clockEnable(false);
+    if ((rtc.beginFast(&rd, 0x00) != (DS1302_FAST_PRESENT | DS1302_FAST_VALID)) ||
+        (rtc.readByteRAM(0x00) != 0)) {
+        errors++;
+    }
+    rtc.clockEnable(true);
+
+#ifdef DS1302_TRACE
+    // Bus transactions of the last workload
+    rtc.dumpTrace(stdout);
+#endif
+
+    return errors;
+}
+
+int main(int argc, char *argv[])
+{
+    uint32_t pinWriteNs = DEFAULT_PIN_ACCESS_NS;
+    uint32_t pinReadNs = DEFAULT_PIN_ACCESS_NS;
+    uint32_t pinModeNs = DEFAULT_PIN_ACCESS_NS;
+    uint32_t pinDelayNs = DEFAULT_PIN_DELAY_NS;
+    uint32_t lo, hi, mid;
+    bool lowVoltage = false;
+    bool search = false;
+    const char *vcdPath = NULL;
+    int errors;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "w:r:m:d:lsv:")) != -1) {
+        switch (opt) {
+            case 'w': pinWriteNs = strtoul(optarg, NULL, 0); break;
+            case 'r': pinReadNs = strtoul(optarg, NULL, 0); break;
+            case 'm': pinModeNs = strtoul(optarg, NULL, 0); break;
+            case 'd': pinDelayNs = strtoul(optarg, NULL, 0); break;
+            case 'l': lowVoltage = true; break;
+            case 's': search = true; break;
+            case 'v': vcdPath = optarg; break;
+            default:
+                fprintf(stderr, "Usage: %s [-w ns] [-r ns] [-m ns] [-d ns] [-l] [-s] [-v file.vcd]\n",
+                        argv[0]);
+                return 2;
+        }
+    }
+
+    if (search) {
+        // Find the smallest DS1302_PIN_DELAY() without timing violations
+        lo = 0;
+        hi = MAX_PIN_DELAY_NS;
+        while (lo < hi) {
+            mid = (lo + hi) / 2;
+            ErriezDS1302Sim sim;
+            sim.setSupplyVoltage(lowVoltage);
+            sim.setTiming(pinWriteNs, pinReadNs, pinModeNs, mid);
+            if ((runWorkload(&sim) == 0) && (sim.getViolations() == 0)) {
+                hi = mid;
+            } else {
+                lo = mid + 1;
+            }
+        }
+        if (lo >= MAX_PIN_DELAY_NS) {
+            // Report the phases which do not depend on DS1302_PIN_DELAY()
+            printf("No pin delay below %lu ns meets the datasheet timing\n\n", MAX_PIN_DELAY_NS);
+        } else {
+            printf("Minimum DS1302_PIN_DELAY(): %u ns\n\n", lo);
+        }
+        pinDelayNs = lo;
+    }
+
+    ErriezDS1302Sim sim;
+    sim.setSupplyVoltage(lowVoltage);
+    sim.setTiming(pinWriteNs, pinReadNs, pinModeNs, pinDelayNs);
+    if (vcdPath && !sim.openVcd(vcdPath)) {
+        fprintf(stderr, "Cannot create %s\n", vcdPath);
+        return 2;
+    }
+
+    errors = runWorkload(&sim);
+    sim.closeVcd();
+
+    printf("Timing model: write %u ns, read %u ns, mode %u ns, delay %u ns, VCC %s\n",
+           pinWriteNs, pinReadNs, pinModeNs, pinDelayNs, lowVoltage ? "2.0V" : "5.0V");
+    printf("Simulated bus time: %llu ns\n\n", (unsigned long long)sim.getTime());
+    sim.printReport(stdout);
+    printf("\nData mismatches: %d\n", errors);
+
+    return (errors || sim.getViolations() || sim.getContentions()) ? 1 : 0;
+}
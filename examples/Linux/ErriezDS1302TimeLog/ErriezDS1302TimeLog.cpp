@@ -0,0 +1,204 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \brief DS1302 RTC delta compressed timestamp log decoder for Linux
+ * \details
+ *    Source:         https://github.com/Erriez/ErriezDS1302
+ *    Documentation:  https://erriez.github.io/ErriezDS1302
+ *
+ *    Decodes a timestamp log written by ErriezDS1302TimeLogEncoder, for example copied from an
+ *    SD card. The file is memory mapped, so seeking in large logs reads only a few pages.
+ *
+ *    Build on the host:
+ *      g++ -O2 -Isrc src/ErriezDS1302TimeLog.cpp \
+ *          examples/Linux/ErriezDS1302TimeLog/ErriezDS1302TimeLog.cpp -o ds1302-timelog
+ *
+ *    Run:
+ *      ./ds1302-timelog [-g number of timestamps (generate test log)] [-s epoch[.ms]]
+ *                       [-n number to print] log.bin
+ */
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include <ErriezDS1302TimeLog.h>
+
+/*!
+ * \brief Get monotonic time in seconds
+ * \return
+ *      Seconds.
+ */
+static double now()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/*!
+ * \brief Generate a test log with 100Hz samples and jitter, millisecond resolution
+ * \param path
+ *      Log file.
+ * \param count
+ *      Number of timestamps.
+ * \retval 0
+ *      Success.
+ */
+static int generate(const char *path, unsigned long count)
+{
+    ErriezDS1302TimeLogEncoder encoder(true);
+    uint8_t record[DS1302_TIMELOG_MAX_RECORD];
+    uint64_t ms = 1600000000000ULL;
+    uint64_t total = 0;
+    FILE *f;
+
+    f = fopen(path, "wb");
+    if (!f) {
+        perror(path);
+        return 1;
+    }
+    for (unsigned long i = 0; i < count; i++) {
+        ms += 8 + (rand() % 5);
+        uint8_t len = encoder.encode((time_t)(ms / 1000), (uint16_t)(ms % 1000), record);
+        fwrite(record, 1, len, f);
+        total += len;
+    }
+    fclose(f);
+
+    printf("%lu timestamps, %llu bytes, %.2f bytes/timestamp\n",
+           count, (unsigned long long)total, (double)total / count);
+
+    return 0;
+}
+
+/*!
+ * \brief Print timestamp
+ * \param t
+ *      Unix epoch.
+ * \param ms
+ *      Milliseconds.
+ */
+static void printTimestamp(time_t t, uint16_t ms)
+{
+    char str[32];
+
+    strftime(str, sizeof(str), "%Y-%m-%d %H:%M:%S", gmtime(&t));
+    printf("%s.%03u UTC\n", str, ms);
+}
+
+int main(int argc, char *argv[])
+{
+    unsigned long generateCount = 0;
+    unsigned long printCount = 5;
+    double seekTime = -1;
+    const uint8_t *buf;
+    struct stat st;
+    uint64_t count = 0;
+    time_t t;
+    uint16_t ms;
+    double start;
+    int opt;
+    int fd;
+
+    while ((opt = getopt(argc, argv, "g:s:n:")) != -1) {
+        switch (opt) {
+            case 'g':
+                generateCount = strtoul(optarg, NULL, 0);
+                break;
+            case 's':
+                seekTime = strtod(optarg, NULL);
+                break;
+            case 'n':
+                printCount = strtoul(optarg, NULL, 0);
+                break;
+            default:
+                fprintf(stderr, "Usage: %s [-g count] [-s epoch[.ms]] [-n count] log.bin\n",
+                        argv[0]);
+                return 1;
+        }
+    }
+    if (optind >= argc) {
+        fprintf(stderr, "Missing log file\n");
+        return 1;
+    }
+
+    if (generateCount) {
+        return generate(argv[optind], generateCount);
+    }
+
+    // Map log file
+    fd = open(argv[optind], O_RDONLY);
+    if ((fd < 0) || (fstat(fd, &st) != 0) || (st.st_size == 0)) {
+        perror(argv[optind]);
+        return 1;
+    }
+    buf = (const uint8_t *)mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (buf == MAP_FAILED) {
+        perror("mmap");
+        return 1;
+    }
+
+    ErriezDS1302TimeLogDecoder decoder(buf, st.st_size);
+
+    if (seekTime >= 0) {
+        // Seek and print timestamps
+        start = now();
+        if (!decoder.seek((time_t)seekTime,
+                          (uint16_t)((seekTime - (time_t)seekTime) * 1000 + 0.5))) {
+            printf("No timestamp at or after %.3f\n", seekTime);
+            return 1;
+        }
+        printf("Seek to offset %zu in %.1f us\n", decoder.tell(), (now() - start) * 1e6);
+        while (printCount-- && decoder.next(&t, &ms)) {
+            printTimestamp(t, ms);
+        }
+    } else {
+        // Decode complete log
+        start = now();
+        while (decoder.next(&t, &ms)) {
+            if (count < printCount) {
+                printTimestamp(t, ms);
+            }
+            count++;
+        }
+        double elapsed = now() - start;
+
+        printf("%llu timestamps, %lld bytes, %.2f bytes/timestamp, %u errors\n",
+               (unsigned long long)count, (long long)st.st_size,
+               count ? (double)st.st_size / count : 0.0, decoder.getErrors());
+        printf("Decoded in %.3f s, %.0f MB/s\n", elapsed, st.st_size / elapsed / 1e6);
+    }
+
+    munmap((void *)buf, st.st_size);
+
+    return 0;
+}
@@ -0,0 +1,251 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \brief DS1302 RTC time page client and reader benchmark for Linux
+ * \details
+ *    Source:         https://github.com/Erriez/ErriezDS1302
+ *    Documentation:  https://erriez.github.io/ErriezDS1302
+ *
+ *    Reads the time published by ErriezDS1302TimePageDaemon without accessing the RTC. Prints
+ *    the time every second with the difference to CLOCK_REALTIME, or measures the reader
+ *    throughput with -b threads, each pinned to a CPU.
+ *
+ *    Build:
+ *      g++ -O2 -pthread -Isrc examples/Linux/ErriezDS1302TimePageClient/ErriezDS1302TimePageClient.cpp \
+ *          -o ds1302-timepage
+ *
+ *    Run:
+ *      ./ds1302-timepage [-n seconds] [-s shm name]
+ *      ./ds1302-timepage -b threads [-n seconds] [-s shm name]
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <ErriezDS1302TimePage.h>
+
+//! Maximum number of benchmark threads
+#define MAX_THREADS     64
+
+//! Cache line size, results of different threads do not share a cache line
+#define CACHE_LINE_SIZE 64
+
+//! Reader benchmark results per thread, stored once at the end of the benchmark
+struct alignas(CACHE_LINE_SIZE) ReaderStats {
+    pthread_t thread;           //!< Thread
+    unsigned long index;        //!< Thread index
+    unsigned long reads;        //!< Successful reads
+    unsigned long failed;       //!< Failed reads
+    unsigned long backward;     //!< Reads earlier than the previous read
+};
+
+static ErriezDS1302TimePage page;           //!< Mapped time page
+static bool benchRunning = true;            //!< Cleared at the end of the benchmark
+
+/*!
+ * \brief Print published flags
+ * \param flags
+ *      DS1302_TIME_PAGE_VALID..DS1302_TIME_PAGE_STALE.
+ */
+static void printFlags(uint32_t flags)
+{
+    printf("%s%s%s%s\n",
+           (flags & DS1302_TIME_PAGE_VALID) ? " VALID" : "",
+           (flags & DS1302_TIME_PAGE_HALTED) ? " CH" : "",
+           (flags & DS1302_TIME_PAGE_SYNCED) ? " SYNCED" : "",
+           (flags & DS1302_TIME_PAGE_STALE) ? " STALE" : "");
+}
+
+/*!
+ * \brief Print the time every second
+ * \param numSeconds
+ *      Number of seconds.
+ * \return
+ *      Exit code.
+ */
+static int monitor(unsigned long numSeconds)
+{
+    DS1302TimeSnapshot snapshot;
+    struct timespec rtcTime;
+    struct timespec realTime;
+    struct tm dt;
+    uint32_t flags;
+    bool valid;
+
+    for (unsigned long i = 0; i < numSeconds; i++) {
+        valid = page.now(&rtcTime, &flags);
+        clock_gettime(CLOCK_REALTIME, &realTime);
+
+        if (!page.read(&snapshot)) {
+            printf("Page not initialized\n");
+        } else {
+            gmtime_r(&rtcTime.tv_sec, &dt);
+            printf("%04d-%02d-%02d %02d:%02d:%02d.%03ld UTC  %+9.3f ms  +/-%7.3f ms  "
+                   "updates %-6u%s",
+                   dt.tm_year + 1900, dt.tm_mon + 1, dt.tm_mday,
+                   dt.tm_hour, dt.tm_min, dt.tm_sec, rtcTime.tv_nsec / 1000000,
+                   ((double)(rtcTime.tv_sec - realTime.tv_sec) * 1e9 +
+                    (rtcTime.tv_nsec - realTime.tv_nsec)) / 1e6,
+                   snapshot.uncertaintyNs / 1e6, snapshot.updates, valid ? "" : " FAIL");
+            printFlags(flags);
+        }
+
+        sleep(1);
+    }
+
+    return 0;
+}
+
+/*!
+ * \brief Benchmark thread reading the time page
+ * \param arg
+ *      ReaderStats of the thread.
+ * \return
+ *      NULL.
+ */
+static void *reader(void *arg)
+{
+    ReaderStats *stats = (ReaderStats *)arg;
+    struct timespec last = { 0, 0 };
+    struct timespec ts;
+    unsigned long reads = 0;
+    unsigned long failed = 0;
+    unsigned long backward = 0;
+    cpu_set_t cpus;
+
+    // Spread threads over the CPUs
+    CPU_ZERO(&cpus);
+    CPU_SET(stats->index % sysconf(_SC_NPROCESSORS_ONLN), &cpus);
+    pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+
+    // Count in registers, so the benchmark measures the time page and not the counters
+    while (__atomic_load_n(&benchRunning, __ATOMIC_RELAXED)) {
+        if (!page.now(&ts)) {
+            failed++;
+            continue;
+        }
+        reads++;
+
+        // Re-anchoring at a new RTC second may step back within the anchor uncertainty
+        if ((ts.tv_sec < last.tv_sec) ||
+            ((ts.tv_sec == last.tv_sec) && (ts.tv_nsec < last.tv_nsec))) {
+            backward++;
+        }
+        last = ts;
+    }
+
+    stats->reads = reads;
+    stats->failed = failed;
+    stats->backward = backward;
+
+    return NULL;
+}
+
+/*!
+ * \brief Measure reader throughput
+ * \param numThreads
+ *      Number of reader threads.
+ * \param numSeconds
+ *      Duration.
+ * \return
+ *      Exit code.
+ */
+static int benchmark(unsigned long numThreads, unsigned long numSeconds)
+{
+    static ReaderStats stats[MAX_THREADS];
+    unsigned long reads = 0;
+    unsigned long failed = 0;
+    unsigned long backward = 0;
+    double seconds = (double)numSeconds;
+
+    for (unsigned long i = 0; i < numThreads; i++) {
+        stats[i].index = i;
+        pthread_create(&stats[i].thread, NULL, reader, &stats[i]);
+    }
+    sleep((unsigned int)numSeconds);
+    __atomic_store_n(&benchRunning, false, __ATOMIC_RELAXED);
+
+    for (unsigned long i = 0; i < numThreads; i++) {
+        pthread_join(stats[i].thread, NULL);
+        printf("Thread %2lu:  %8.2f M reads/s\n", i, stats[i].reads / seconds / 1e6);
+        reads += stats[i].reads;
+        failed += stats[i].failed;
+        backward += stats[i].backward;
+    }
+
+    printf("Threads:          %lu on %ld CPUs\n", numThreads, sysconf(_SC_NPROCESSORS_ONLN));
+    printf("Total:            %.2f M reads/s\n", reads / seconds / 1e6);
+    printf("Per thread:       %.1f ns/read\n", reads ? (seconds * numThreads * 1e9) / reads : 0);
+    printf("Failed reads:     %lu\n", failed);
+    printf("Backward steps:   %lu\n", backward);
+
+    return failed ? 1 : 0;
+}
+
+int main(int argc, char *argv[])
+{
+    const char *shmName = DS1302_TIME_PAGE_NAME;
+    unsigned long numThreads = 0;
+    unsigned long numSeconds = 0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "b:n:s:")) != -1) {
+        switch (opt) {
+            case 'b':
+                numThreads = strtoul(optarg, NULL, 0);
+                break;
+            case 'n':
+                numSeconds = strtoul(optarg, NULL, 0);
+                break;
+            case 's':
+                shmName = optarg;
+                break;
+            default:
+                fprintf(stderr, "Usage: %s [-b threads] [-n seconds] [-s shm name]\n", argv[0]);
+                return 1;
+        }
+    }
+    if (numThreads > MAX_THREADS) {
+        fprintf(stderr, "Number of threads 1..%d\n", MAX_THREADS);
+        return 1;
+    }
+
+    if (!page.open(shmName)) {
+        fprintf(stderr, "Cannot open %s, daemon not running?\n", shmName);
+        return 1;
+    }
+
+    if (numThreads) {
+        return benchmark(numThreads, numSeconds ? numSeconds : 5);
+    }
+
+    return monitor(numSeconds ? numSeconds : 10);
+}
@@ -0,0 +1,253 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \brief DS1302 RTC time page daemon for Linux
+ * \details
+ *    Source:         https://github.com/Erriez/ErriezDS1302
+ *    Documentation:  https://erriez.github.io/ErriezDS1302
+ *
+ *    Owns the DS1302 bus and publishes the RTC time in a shared memory page for all processes
+ *    on the system, see ErriezDS1302TimePage.h. The seconds register is polled every -i ms.
+ *    A change of seconds starts a new RTC second: the date/time is read and published
+ *    with the CLOCK_MONOTONIC anchor halfway between the two polls.
+ *
+ *    Build on the Linux target:
+ *      g++ -O2 -Isrc src/ErriezDS1302*.cpp \
+ *          examples/Linux/ErriezDS1302TimePageDaemon/ErriezDS1302TimePageDaemon.cpp \
+ *          -o ds1302-timepaged
+ *
+ *    Build on the host with a simulated chip, set to the host time and advanced every second:
+ *      g++ -O2 -DDS1302_SIMULATOR -Isrc src/ErriezDS1302*.cpp \
+ *          examples/Linux/ErriezDS1302TimePageDaemon/ErriezDS1302TimePageDaemon.cpp \
+ *          -o ds1302-timepaged
+ *
+ *    Run:
+ *      ./ds1302-timepaged [-c /dev/gpiochipN] [-l CLK,IO,CE] [-i poll interval ms]
+ *                         [-n seconds] [-s shm name]
+ */
+
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <ErriezDS1302.h>
+#include <ErriezDS1302TimePage.h>
+#include <ErriezDS1302TimeZone.h>
+
+//! ns per second
+#define NS_PER_SEC      1000000000LL
+
+static volatile sig_atomic_t running = 1;   //!< Cleared by SIGINT / SIGTERM
+
+/*!
+ * \brief Stop the daemon
+ * \param sig
+ *      Signal number.
+ */
+static void stop(int sig)
+{
+    (void)sig;
+    running = 0;
+}
+
+/*!
+ * \brief Sleep until monotonic time
+ * \param ns
+ *      CLOCK_MONOTONIC in ns.
+ */
+static void sleepUntil(int64_t ns)
+{
+    struct timespec ts;
+
+    ts.tv_sec = (time_t)(ns / NS_PER_SEC);
+    ts.tv_nsec = (long)(ns % NS_PER_SEC);
+    clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+}
+
+int main(int argc, char *argv[])
+{
+    ErriezDS1302TimePage page;
+    const char *shmName = DS1302_TIME_PAGE_NAME;
+    unsigned long intervalMs = 10;
+    unsigned long numSeconds = 0;
+    uint8_t lastSeconds = 0xFF;
+    int64_t lastPollNs = 0;
+    int64_t publishNs = 0;
+    int64_t startNs;
+    int64_t pollNs;
+    struct tm dt;
+    uint8_t seconds;
+    bool retry;
+    uint32_t flags;
+    int opt;
+
+#ifdef DS1302_SIMULATOR
+    ErriezDS1302Sim sim;
+    ErriezDS1302 rtc(&sim);
+    int64_t nextTickNs;
+    struct timespec ts;
+#else
+    const char *chipPath = "/dev/gpiochip0";
+    unsigned int clkLine = 0;
+    unsigned int ioLine = 1;
+    unsigned int ceLine = 2;
+#endif
+
+    while ((opt = getopt(argc, argv, "c:l:i:n:s:")) != -1) {
+        switch (opt) {
+#ifndef DS1302_SIMULATOR
+            case 'c':
+                chipPath = optarg;
+                break;
+            case 'l':
+                if (sscanf(optarg, "%u,%u,%u", &clkLine, &ioLine, &ceLine) != 3) {
+                    fprintf(stderr, "Invalid lines %s\n", optarg);
+                    return 1;
+                }
+                break;
+#endif
+            case 'i':
+                intervalMs = strtoul(optarg, NULL, 0);
+                break;
+            case 'n':
+                numSeconds = strtoul(optarg, NULL, 0);
+                break;
+            case 's':
+                shmName = optarg;
+                break;
+            default:
+                fprintf(stderr, "Usage: %s [-c /dev/gpiochipN] [-l CLK,IO,CE] [-i poll interval ms] "
+                                "[-n seconds] [-s shm name]\n", argv[0]);
+                return 1;
+        }
+    }
+    if ((intervalMs < 1) || (intervalMs > 500)) {
+        fprintf(stderr, "Poll interval 1..500 ms\n");
+        return 1;
+    }
+
+#ifndef DS1302_SIMULATOR
+    ErriezDS1302 rtc(chipPath, (uint8_t)clkLine, (uint8_t)ioLine, (uint8_t)ceLine);
+#endif
+
+    if (!page.create(shmName)) {
+        fprintf(stderr, "Cannot create %s, daemon already running?\n", shmName);
+        return 1;
+    }
+
+#ifdef DS1302_SIMULATOR
+    // ESP32 like pin timing without violations
+    sim.setTiming(300, 300, 300, 1000);
+#endif
+
+    if (!rtc.begin()) {
+        fprintf(stderr, "RTC not found\n");
+        return 1;
+    }
+
+#ifdef DS1302_SIMULATOR
+    // Simulated chip starts at the next second of CLOCK_REALTIME
+    clock_gettime(CLOCK_REALTIME, &ts);
+    nextTickNs = ErriezDS1302TimePage::monotonicNs() + (NS_PER_SEC - ts.tv_nsec);
+    sleepUntil(nextTickNs);
+    rtc.setEpoch(ts.tv_sec + 1);
+    nextTickNs += NS_PER_SEC;
+#endif
+
+    signal(SIGINT, stop);
+    signal(SIGTERM, stop);
+
+    startNs = ErriezDS1302TimePage::monotonicNs();
+    printf("Publishing %s, poll interval %lu ms\n", shmName, intervalMs);
+
+    while (running) {
+        pollNs = ErriezDS1302TimePage::monotonicNs();
+        if (numSeconds && ((pollNs - startNs) >= ((int64_t)numSeconds * NS_PER_SEC))) {
+            break;
+        }
+
+#ifdef DS1302_SIMULATOR
+        while (pollNs >= nextTickNs) {
+            sim.advance(1);
+            nextTickNs += NS_PER_SEC;
+        }
+#endif
+
+        seconds = rtc.readRegister(DS1302_REG_SECONDS);
+        retry = false;
+
+        if ((seconds != lastSeconds) ||
+            ((seconds & 0x80) && ((pollNs - publishNs) >= NS_PER_SEC))) {
+            flags = 0;
+
+            if (seconds & 0x80) {
+                flags |= DS1302_TIME_PAGE_HALTED;
+            }
+
+            if (!rtc.read(&dt)) {
+                // Invalid date/time, retry at the next second
+                page.publish(0, pollNs, 0, flags);
+            } else if (dt.tm_sec != rtc.bcdToDec(seconds & 0x7F)) {
+                // Seconds changed during the burst read: retry at the next poll, and keep the
+                // previous poll as start of the anchor window
+                retry = true;
+            } else {
+                flags |= DS1302_TIME_PAGE_VALID;
+
+                if ((lastSeconds != 0xFF) && !(seconds & 0x80) &&
+                    ((pollNs - lastPollNs) <= (2 * (int64_t)intervalMs * 1000000LL))) {
+                    // Second started between the previous and this poll
+                    flags |= DS1302_TIME_PAGE_SYNCED;
+                    page.publish(ErriezDS1302TimeZone::makeTime(&dt),
+                                 (lastPollNs + pollNs) / 2,
+                                 (uint32_t)((pollNs - lastPollNs) / 2), flags);
+                } else {
+                    // First read or halted: start of the second unknown
+                    page.publish(ErriezDS1302TimeZone::makeTime(&dt), pollNs,
+                                 (uint32_t)NS_PER_SEC, flags);
+                }
+            }
+            if (!retry) {
+                publishNs = pollNs;
+            }
+        }
+
+        if (!retry) {
+            lastSeconds = seconds;
+            lastPollNs = pollNs;
+        }
+
+        sleepUntil(pollNs + ((int64_t)intervalMs * 1000000LL));
+    }
+
+    // Clients report the page stale
+    page.close();
+
+#ifdef DS1302_SIMULATOR
+    printf("Timing violations: %u\n", sim.getViolations());
+#endif
+
+    return 0;
+}
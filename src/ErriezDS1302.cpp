@@ -31,6 +31,9 @@
  */
 
 #include "ErriezDS1302.h"
+#if defined(ARDUINO) && DS1302_FEATURE_BUS
+#include "ErriezDS1302Bus.h"
+#endif
 
 /*!
  * \brief Constructor DS1302 RTC.
@@ -56,7 +59,61 @@ ErriezDS1302::ErriezDS1302(uint8_t clkPin, uint8_t ioPin, uint8_t cePin)
     _ioPin = ioPin;
     _cePin = cePin;
 #endif
+#ifdef DS1302_LINUX_GPIO
+    _chipPath = "/dev/gpiochip0";
+    _lineFd = -1;
+    _lineValues = 0;
+    _lineActual = 0;
+    _ioInput = false;
+    _ioInputActual = false;
+    _lineError = false;
+    _syscalls = 0;
+    _transferStart = 0;
+    _transferSyscalls = 0;
+#endif
+#if defined(ARDUINO) && DS1302_FEATURE_BUS
+    _bus = NULL;
+#endif
+#ifdef DS1302_SIMULATOR
+    _sim = NULL;
+#endif
+#ifdef DS1302_TRACE
+    clearTrace();
+#endif
+}
+
+#if defined(ARDUINO) && DS1302_FEATURE_BUS
+/*!
+ * \brief Constructor DS1302 RTC on a shared CLK/IO bus.
+ * \details
+ *      Attach all devices to the bus with ErriezDS1302Bus::attach() before calling begin() of
+ *      any device, so that all CE pins are low before the first transfer.
+ * \param bus
+ *      Shared bus which owns the CLK and IO pins.
+ * \param cePin
+ *      Chip select pin of this device.
+ */
+ErriezDS1302::ErriezDS1302(ErriezDS1302Bus *bus, uint8_t cePin) :
+        ErriezDS1302(bus->_clkPin, bus->_ioPin, cePin)
+{
+    _bus = bus;
+}
+#endif
+
+#ifdef DS1302_SIMULATOR
+/*!
+ * \brief Constructor DS1302 RTC connected to a simulated chip.
+ * \param sim
+ *      Simulator.
+ */
+ErriezDS1302::ErriezDS1302(ErriezDS1302Sim *sim) :
+        _clkPin(DS1302_SIM_CLK), _ioPin(DS1302_SIM_IO), _cePin(DS1302_SIM_CE), _sim(sim)
+{
+#ifdef DS1302_TRACE
+    clearTrace();
+#endif
 }
+#endif
 
 /*!
  * \brief Initialize and detect DS1302 RTC.
@@ -69,14 +126,9 @@ ErriezDS1302::ErriezDS1302(uint8_t clkPin, uint8_t ioPin, uint8_t cePin)
  */
 bool ErriezDS1302::begin()
 {
-    // Initialize pins
-    DS1302_CLK_LOW();
-    DS1302_IO_LOW();
-    DS1302_CE_LOW();
-
-    DS1302_CLK_OUTPUT();
-    DS1302_IO_OUTPUT();
-    DS1302_CE_OUTPUT();
+    if (!initPins()) {
+        return false;
+    }
 
     // Check zero bits in day week register
     if (readRegister(DS1302_REG_DAY_WEEK) & 0xF8) {
@@ -84,7 +136,9 @@ bool ErriezDS1302::begin()
     }
 
     // Remove write protect
-    writeRegister(DS1302_REG_WP, 0);
+    if (!writeRegister(DS1302_REG_WP, 0)) {
+        return false;
+    }
 
     // Check write protect bit
     if (readRegister(DS1302_REG_WP) & (1 << DS1302_BIT_WP)) {
@@ -96,6 +150,91 @@ bool ErriezDS1302::begin()
     return true;
 }
 
+#if DS1302_FEATURE_TM
+/*!
+ * \brief Fast start: initialize and probe DS1302 RTC with a single clock burst read.
+ * \details
+ *      Call this function instead of begin(), isRunning() and read() on every wake-up. Presence,
+ *      the write protect bit, the oscillator and the validity of the date/time registers are
+ *      checked with one 8-byte clock burst read. A write is issued only when write protect is
+ *      set. The oscillator is not started: set the date/time when DS1302_FAST_RUNNING or
+ *      DS1302_FAST_VALID is not set.
+ *
+ *      Optionally, a RAM byte is used as "known good" warm-boot flag. The application writes
+ *      DS1302_WARM_BOOT_MAGIC to this RAM address after setting the date/time. The flag is read
+ *      only when the clock is running and valid, and is cleared when it is not and not yet
+ *      cleared. The flag is not used when DS1302_FEATURE_RAM is 0.
+ * \param dt
+ *      Date/time struct tm, or NULL. Contains the date/time when DS1302_FAST_VALID is set.
+ * \param warmBootAddr
+ *      RAM address 0..30 of the warm-boot flag, or DS1302_NO_WARM_BOOT.
+ * \return
+ *      DS1302_FAST_* status flags, 0 when the RTC is not detected or write protect could not
+ *      be cleared.
+ */
+uint8_t ErriezDS1302::beginFast(struct tm *dt, uint8_t warmBootAddr)
+{
+    uint8_t buffer[DS1302_NUM_CLOCK_REGS + 1];
+    struct tm tmp;
+    uint8_t status;
+
+    if (!initPins()) {
+        return 0;
+    }
+
+    // Read clock registers including write protect register with one burst
+    if (!readBuffer(0x00, buffer, sizeof(buffer))) {
+        return 0;
+    }
+
+    // Check zero bits in day week and write protect registers
+    if ((buffer[DS1302_REG_DAY_WEEK] & 0xF8) || (buffer[DS1302_REG_WP] & 0x7F)) {
+        return 0;
+    }
+    status = DS1302_FAST_PRESENT;
+
+    // Remove write protect only when set
+    if (buffer[DS1302_REG_WP] & (1 << DS1302_BIT_WP)) {
+        if (!writeRegister(DS1302_REG_WP, 0)) {
+            // Error: RTC not writable, like begin()
+            return 0;
+        }
+        status |= DS1302_FAST_WP_CLEARED;
+    }
+
+    if (!(buffer[DS1302_REG_SECONDS] & (1 << DS1302_SEC_CH))) {
+        status |= DS1302_FAST_RUNNING;
+    }
+
+    // Check date/time, month and day of the week registers start at 1
+    if (decodeClock(buffer, dt ? dt : &tmp) && (buffer[DS1302_REG_MONTH] != 0) &&
+        (buffer[DS1302_REG_DAY_WEEK] != 0)) {
+        status |= DS1302_FAST_VALID;
+    }
+
+#if DS1302_FEATURE_RAM
+    // Check warm-boot flag in RAM
+    if (warmBootAddr < DS1302_NUM_RAM_REGS) {
+        uint8_t flag = readByteRAM(warmBootAddr);
+
+        if ((status & (DS1302_FAST_RUNNING | DS1302_FAST_VALID)) ==
+                (DS1302_FAST_RUNNING | DS1302_FAST_VALID)) {
+            if (flag == DS1302_WARM_BOOT_MAGIC) {
+                status |= DS1302_FAST_WARM_BOOT;
+            }
+        } else if (flag != 0) {
+            // Date/time lost: invalidate flag
+            writeByteRAM(warmBootAddr, 0);
+        }
+    }
+#else
+    (void)warmBootAddr;
+#endif
+
+    return status;
+}
+#endif // DS1302_FEATURE_TM
+
 /*!
  * \brief Read RTC CH (Clock Halt) from seconds register.
  * \details
@@ -151,6 +290,7 @@ bool ErriezDS1302::clockEnable(bool enable)
     return writeRegister(DS1302_REG_SECONDS, regSeconds);
 }
 
+#if DS1302_FEATURE_EPOCH
 /*!
  * \brief Read Unix UTC epoch time_t
  * \return
@@ -203,7 +343,9 @@ bool ErriezDS1302::setEpoch(time_t t)
     // Write date/time to RTC
     return write(dt);
 }
+#endif // DS1302_FEATURE_EPOCH
 
+#if DS1302_FEATURE_TM
 /*!
  * \brief Read date and time from RTC.
  * \details
@@ -226,6 +368,22 @@ bool ErriezDS1302::read(struct tm *dt)
         return false;
     }
 
+    return decodeClock(buffer, dt);
+}
+
+/*!
+ * \brief Convert clock registers to date and time.
+ * \param buffer
+ *      BCD encoded clock registers 0x00..0x06.
+ * \param dt
+ *      Date and time struct tm.
+ * \retval true
+ *      Success
+ * \retval false
+ *      Invalid date/time in clock registers.
+ */
+bool ErriezDS1302::decodeClock(const uint8_t *buffer, struct tm *dt)
+{
     // Clear dt
     memset(dt, 0, sizeof(struct tm));
 
@@ -289,11 +447,14 @@ bool ErriezDS1302::write(const struct tm *dt)
     // Write BCD encoded buffer to RTC registers
     return writeBuffer(0x00, buffer, sizeof(buffer));
 }
+#endif // DS1302_FEATURE_TM
 
 /*!
  * \brief Write time to RTC.
  * \details
- *      Write hour, minute and second registers to RTC.
+ *      Write hour, minute and second registers to RTC with single register writes. The date
+ *      registers are not read or written. Seconds are cleared first, so that no minute or hour
+ *      carry can occur between the register writes. This function enables the oscillator.
  * \param hour
  *      Hours 0..23.
  * \param min
@@ -303,28 +464,133 @@ bool ErriezDS1302::write(const struct tm *dt)
  * \retval true
  *      Success.
  * \retval false
- *      Set time failed.
+ *      Invalid time or write failed.
  */
 bool ErriezDS1302::setTime(uint8_t hour, uint8_t min, uint8_t sec)
 {
-    struct tm dt;
+    if ((hour > 23) || (min > 59) || (sec > 59)) {
+        return false;
+    }
 
-    // Read date/time from RTC
-    read(&dt);
+    // Remove write protect
+    if (!writeRegister(DS1302_REG_WP, 0)) {
+        return false;
+    }
 
-    // Update time
-    dt.tm_hour = hour;
-    dt.tm_min = min;
-    dt.tm_sec = sec;
+    // Clear seconds and CH bit
+    if (!writeRegister(DS1302_REG_SECONDS, 0)) {
+        return false;
+    }
 
-    // Write date/time to RTC
-    return write(&dt);
+    // Write minutes and hours in 24-hour mode
+    if (!writeRegister(DS1302_REG_MINUTES, decToBcd(min)) ||
+        !writeRegister(DS1302_REG_HOURS, decToBcd(hour))) {
+        return false;
+    }
+
+    // Write seconds
+    if (sec) {
+        return writeRegister(DS1302_REG_SECONDS, decToBcd(sec));
+    }
+
+    return true;
+}
+
+/*!
+ * \brief Write date to RTC.
+ * \details
+ *      Write day of the month, month, year and day of the week registers to RTC with single
+ *      register writes. The time registers are not written. When called at 23:59:59, the
+ *      function waits up to a second for midnight, so that no date carry can occur between the
+ *      register writes.
+ * \param mday
+ *      Day of the month 1..31
+ * \param mon
+ *      Month 1..12 (1=January)
+ * \param year
+ *      Year 2000..2099
+ * \param wday
+ *      Day of the week 0..6 (0=Sunday, .. 6=Saturday)
+ * \retval true
+ *      Success.
+ * \retval false
+ *      Invalid date or write failed.
+ */
+bool ErriezDS1302::setDate(uint8_t mday, uint8_t mon, uint16_t year, uint8_t wday)
+{
+    if ((mday < 1) || (mday > 31) || (mon < 1) || (mon > 12) || (year < 2000) ||
+        (year > 2099) || (wday > 6)) {
+        return false;
+    }
+
+    // Remove write protect
+    if (!writeRegister(DS1302_REG_WP, 0)) {
+        return false;
+    }
+
+    waitDateRollover();
+
+    // Write date registers
+    if (!writeRegister(DS1302_REG_DAY_MONTH, decToBcd(mday)) ||
+        !writeRegister(DS1302_REG_MONTH, decToBcd(mon)) ||
+        !writeRegister(DS1302_REG_YEAR, decToBcd(year - 2000))) {
+        return false;
+    }
+
+    return writeRegister(DS1302_REG_DAY_WEEK, decToBcd(wday + 1));
+}
+
+/*!
+ * \brief Write a single date/time field to RTC.
+ * \details
+ *      Only the register of the field is written. Writing seconds enables the oscillator.
+ * \param reg
+ *      DS1302_REG_SECONDS, DS1302_REG_MINUTES, DS1302_REG_HOURS, DS1302_REG_DAY_MONTH,
+ *      DS1302_REG_MONTH, DS1302_REG_DAY_WEEK or DS1302_REG_YEAR.
+ * \param value
+ *      Seconds 0..59, minutes 0..59, hours 0..23, day of the month 1..31, month 1..12,
+ *      day of the week 0..6 (0=Sunday) or year 2000..2099.
+ * \retval true
+ *      Success.
+ * \retval false
+ *      Invalid register or value, or write failed.
+ */
+bool ErriezDS1302::setField(uint8_t reg, uint16_t value)
+{
+    static const uint8_t minValue[DS1302_NUM_CLOCK_REGS] = { 0, 0, 0, 1, 1, 1, 0 };
+    static const uint8_t maxValue[DS1302_NUM_CLOCK_REGS] = { 59, 59, 23, 31, 12, 7, 99 };
+
+    if (reg >= DS1302_NUM_CLOCK_REGS) {
+        return false;
+    }
+
+    // Convert to register range
+    if (reg == DS1302_REG_DAY_WEEK) {
+        value++;
+    } else if (reg == DS1302_REG_YEAR) {
+        if (value < 2000) {
+            return false;
+        }
+        value -= 2000;
+    }
+
+    if ((value < minValue[reg]) || (value > maxValue[reg])) {
+        return false;
+    }
+
+    // Remove write protect and write register
+    if (!writeRegister(DS1302_REG_WP, 0)) {
+        return false;
+    }
+
+    return writeRegister(reg, decToBcd((uint8_t)value));
 }
 
 /*!
  * \brief Read time from RTC.
  * \details
- *      Read hour, minute and second registers from RTC.
+ *      Read hour, minute and second registers from RTC with one 3-byte burst. The date registers
+ *      are not read.
  * \param hour
  *      Hours 0..23.
  * \param min
@@ -334,25 +600,61 @@ bool ErriezDS1302::setTime(uint8_t hour, uint8_t min, uint8_t sec)
  * \retval true
  *      Success.
  * \retval false
- *      Invalid second, minute or hour read from RTC. The time is set to zero.
+ *      Read failed, or invalid second, minute or hour read from RTC. The time is set to zero.
  */
 bool ErriezDS1302::getTime(uint8_t *hour, uint8_t *min, uint8_t *sec)
 {
-    struct tm dt;
+    uint8_t buffer[3];
 
-    // Read date/time from RTC
-    if (!read(&dt)) {
+    // Read seconds, minutes and hours registers with one burst
+    if (!readBuffer(0x00, buffer, sizeof(buffer))) {
+        *hour = 0;
+        *min = 0;
+        *sec = 0;
         return false;
     }
 
-    // Set return values
-    *hour = dt.tm_hour;
-    *min = dt.tm_min;
-    *sec = dt.tm_sec;
+    *sec = bcdToDec(buffer[0] & 0x7F);
+    *min = bcdToDec(buffer[1] & 0x7F);
+    *hour = bcdToDec(buffer[2] & 0x3F);
+
+    if ((*sec > 59) || (*min > 59) || (*hour > 23)) {
+        *hour = 0;
+        *min = 0;
+        *sec = 0;
+        return false;
+    }
+
+    return true;
+}
+
+/*!
+ * \brief Read seconds since midnight from RTC.
+ * \details
+ *      Raw register access without struct tm, available in all build profiles.
+ * \param seconds
+ *      Seconds of the day 0..86399.
+ * \retval true
+ *      Success.
+ * \retval false
+ *      Read failed, or invalid second, minute or hour read from RTC.
+ */
+bool ErriezDS1302::getSecondsOfDay(uint32_t *seconds)
+{
+    uint8_t hour;
+    uint8_t min;
+    uint8_t sec;
+
+    if (!getTime(&hour, &min, &sec)) {
+        return false;
+    }
+
+    *seconds = (uint32_t)hour * 3600 + (uint16_t)min * 60 + sec;
 
     return true;
 }
 
+#if DS1302_FEATURE_TM
 /*!
  * \brief Set date time
  * \param hour
@@ -436,7 +738,9 @@ bool ErriezDS1302::getDateTime(uint8_t *hour, uint8_t *min, uint8_t *sec,
 
     return true;
 }
+#endif // DS1302_FEATURE_TM
 
+#if DS1302_FEATURE_RAM
 /*!
  * \brief Write a byte to RAM
  * \param addr
@@ -461,9 +765,13 @@ void ErriezDS1302::writeByteRAM(uint8_t addr, uint8_t value)
  */
 void ErriezDS1302::writeBufferRAM(uint8_t *buf, uint8_t len)
 {
+    if (len > DS1302_NUM_RAM_REGS) {
+        len = DS1302_NUM_RAM_REGS;
+    }
+
     transferBegin();
     writeAddrCmd(DS1302_CMD_WRITE_RAM_BURST);
-    for (uint8_t i = 0; i < min((int)len, DS1302_NUM_RAM_REGS); i++) {
+    for (uint8_t i = 0; i < len; i++) {
         writeByte(*buf++);
     }
     transferEnd();
@@ -474,7 +782,7 @@ void ErriezDS1302::writeBufferRAM(uint8_t *buf, uint8_t len)
  * \param addr
  *      RAM address 0..0x1E
  * \return
- *      RAM byte 0..0xFF
+ *      RAM byte 0..0xFF, 0xFF when a GPIO ioctl failed (Linux)
  */
 uint8_t ErriezDS1302::readByteRAM(uint8_t addr)
 {
@@ -483,7 +791,9 @@ uint8_t ErriezDS1302::readByteRAM(uint8_t addr)
     transferBegin();
     writeAddrCmd(DS1302_CMD_READ_RAM(addr));
     value = readByte();
-    transferEnd();
+    if (!transferEnd()) {
+        value = 0xFF;
+    }
 
     return value;
 }
@@ -497,13 +807,18 @@ uint8_t ErriezDS1302::readByteRAM(uint8_t addr)
  */
 void ErriezDS1302::readBufferRAM(uint8_t *buf, uint8_t len)
 {
+    if (len > DS1302_NUM_RAM_REGS) {
+        len = DS1302_NUM_RAM_REGS;
+    }
+
     transferBegin();
     writeAddrCmd(DS1302_CMD_READ_RAM_BURST);
-    for (uint8_t i = 0; i < min((int)len, DS1302_NUM_RAM_REGS); i++) {
+    for (uint8_t i = 0; i < len; i++) {
         *buf++ = readByte();
     }
     transferEnd();
 }
+#endif // DS1302_FEATURE_RAM
 
 /*!
  * \brief BCD to decimal conversion.
@@ -536,7 +851,7 @@ uint8_t ErriezDS1302::decToBcd(uint8_t dec)
  * \param reg
  *      RTC register number 0x00..0x09.
  * \returns value
- *      8-bit unsigned register value.
+ *      8-bit unsigned register value, 0xFF when a GPIO ioctl failed (Linux).
  */
 uint8_t ErriezDS1302::readRegister(uint8_t reg)
 {
@@ -546,7 +861,9 @@ uint8_t ErriezDS1302::readRegister(uint8_t reg)
     transferBegin();
     writeAddrCmd(DS1302_CMD_READ_CLOCK_REG(reg));
     value = readByte();
-    transferEnd();
+    if (!transferEnd()) {
+        value = 0xFF;
+    }
 
     return value;
 }
@@ -570,9 +887,8 @@ bool ErriezDS1302::writeRegister(uint8_t reg, uint8_t value)
     transferBegin();
     writeAddrCmd((uint8_t)DS1302_CMD_WRITE_CLOCK_REG(reg));
     writeByte(value);
-    transferEnd();
 
-    return true;
+    return transferEnd();
 }
 
 /*!
@@ -590,7 +906,7 @@ bool ErriezDS1302::writeRegister(uint8_t reg, uint8_t value)
  * \retval false
  *      Write failed.
  */
-bool ErriezDS1302::writeBuffer(uint8_t reg, void *buffer, uint8_t writeLen)
+bool ErriezDS1302::writeBuffer(uint8_t reg, const void *buffer, uint8_t writeLen)
 {
     if ((reg != 0) || (writeLen != (DS1302_NUM_CLOCK_REGS + 1))) {
         // Burst command requires all clock registers including write protect
@@ -600,12 +916,11 @@ bool ErriezDS1302::writeBuffer(uint8_t reg, void *buffer, uint8_t writeLen)
     // Write buffer with clock burst command to clock registers
     transferBegin();
     writeAddrCmd(DS1302_CMD_WRITE_CLOCK_BURST);
-    for (uint8_t i = 0; i < min((int)writeLen, DS1302_NUM_RAM_REGS); i++) {
-        writeByte(((uint8_t *)buffer)[i]);
+    for (uint8_t i = 0; i < writeLen; i++) {
+        writeByte(((const uint8_t *)buffer)[i]);
     }
-    transferEnd();
 
-    return true;
+    return transferEnd();
 }
 
 /*!
@@ -627,38 +942,141 @@ bool ErriezDS1302::readBuffer(uint8_t reg, void *buffer, uint8_t readLen)
         // Burst command requires address 0
         return false;
     }
+    if (readLen > DS1302_NUM_RAM_REGS) {
+        readLen = DS1302_NUM_RAM_REGS;
+    }
 
     // Read buffer with clock burst command from clock registers
     transferBegin();
     writeAddrCmd(DS1302_CMD_READ_CLOCK_BURST);
-    for (uint8_t i = 0; i < min((int)readLen, DS1302_NUM_RAM_REGS); i++) {
+    for (uint8_t i = 0; i < readLen; i++) {
         ((uint8_t *)buffer)[i] = readByte();
     }
-    transferEnd();
 
-    return true;
+    return transferEnd();
 }
 
 // -------------------------------------------------------------------------------------------------
 // Private functions
 // -------------------------------------------------------------------------------------------------
+/*!
+ * \brief Initialize pins
+ * \retval true
+ *      Success.
+ * \retval false
+ *      Pins not available.
+ */
+bool ErriezDS1302::initPins()
+{
+#ifdef DS1302_LINUX_GPIO
+    // Request CLK, IO and CE lines from the GPIO character device
+    if (!gpioOpen()) {
+        return false;
+    }
+#endif
+#ifdef DS1302_SIMULATOR
+    if (!_sim) {
+        return false;
+    }
+#endif
+
+    // Initialize pins
+#if defined(ARDUINO) && DS1302_FEATURE_BUS
+    if (!_bus || !_bus->_initialized) {
+#endif
+        DS1302_CLK_LOW();
+        DS1302_IO_LOW();
+        DS1302_CLK_OUTPUT();
+        DS1302_IO_OUTPUT();
+#if defined(ARDUINO) && DS1302_FEATURE_BUS
+        if (_bus) {
+            // CLK and IO are initialized once for all devices on the bus
+            _bus->_initialized = true;
+            _bus->_ioInput = false;
+        }
+    }
+#endif
+    initCe();
+
+    return true;
+}
+
+/*!
+ * \brief Wait until the date registers cannot roll over during the next register writes
+ * \details
+ *      Reads the hours register, and only at 23:59:59 with a running oscillator waits for
+ *      midnight. A halted oscillator (CH bit set) reads 0xD9 and does not wait.
+ */
+void ErriezDS1302::waitDateRollover()
+{
+    if ((readRegister(DS1302_REG_HOURS) != 0x23) ||
+        (readRegister(DS1302_REG_MINUTES) != 0x59)) {
+        return;
+    }
+
+    // Wait at most a second, only when the oscillator is running
+    while (readRegister(DS1302_REG_SECONDS) == 0x59) {
+        ;
+    }
+}
+
+/*!
+ * \brief Initialize CE pin low
+ */
+void ErriezDS1302::initCe()
+{
+    DS1302_CE_LOW();
+    DS1302_CE_OUTPUT();
+}
+
 /*!
  * \brief Start RTC transfer
  */
 void ErriezDS1302::transferBegin()
 {
+    DS1302_TRACE_BEGIN();
+#ifdef DS1302_LINUX_GPIO
+    _transferStart = _syscalls;
+    _lineError = false;
+#endif
     DS1302_CLK_LOW();
     DS1302_IO_LOW();
+#if defined(ARDUINO) && DS1302_FEATURE_BUS
+    if (_bus) {
+        // Skip IO direction change when the previous transfer on the bus was a write
+        if (_bus->_ioInput) {
+            DS1302_IO_OUTPUT();
+            _bus->_ioInput = false;
+        }
+    } else {
+        DS1302_IO_OUTPUT();
+    }
+#else
     DS1302_IO_OUTPUT();
+#endif
     DS1302_CE_HIGH();
 }
 
 /*!
  * \brief End RTC transfer
+ * \retval true
+ *      Success.
+ * \retval false
+ *      A GPIO ioctl of the transfer failed (Linux).
  */
-void ErriezDS1302::transferEnd()
+bool ErriezDS1302::transferEnd()
 {
     DS1302_CE_LOW();
+#ifdef DS1302_LINUX_GPIO
+    _transferSyscalls = _syscalls - _transferStart;
+#endif
+    DS1302_TRACE_END();
+
+#ifdef DS1302_LINUX_GPIO
+    return !_lineError;
+#else
+    return true;
+#endif
 }
 
 /*!
@@ -668,6 +1086,8 @@ void ErriezDS1302::transferEnd()
  */
 void ErriezDS1302::writeAddrCmd(uint8_t value)
 {
+    DS1302_TRACE_CMD(value);
+
     // Write 8 bits to RTC
     for (uint8_t i = 0; i < 8; i++) {
         if (value & (1 << i)) {
@@ -681,6 +1101,11 @@ void ErriezDS1302::writeAddrCmd(uint8_t value)
 
         if ((value & (1 << DS1302_BIT_READ)) && (i == 7)) {
             DS1302_IO_INPUT();
+#if defined(ARDUINO) && DS1302_FEATURE_BUS
+            if (_bus) {
+                _bus->_ioInput = true;
+            }
+#endif
         } else {
             DS1302_CLK_LOW();
         }
@@ -694,6 +1119,8 @@ void ErriezDS1302::writeAddrCmd(uint8_t value)
  */
 void ErriezDS1302::writeByte(uint8_t value)
 {
+    DS1302_TRACE_BYTE(value);
+
     // Write 8 bits to RTC
     for (uint8_t i = 0; i < 8; i++) {
         if (value & 0x01) {
@@ -729,6 +1156,159 @@ uint8_t ErriezDS1302::readByte()
             value &= ~(0x80);
         }
     }
+    DS1302_TRACE_BYTE(value);
 
     return value;
-}
\ No newline at end of file
+}
+
+#ifdef DS1302_TRACE
+/*!
+ * \brief Copy trace records, oldest first.
+ * \param records
+ *      Destination array.
+ * \param maxRecords
+ *      Number of records in the destination array.
+ * \return
+ *      Number of records copied.
+ */
+uint8_t ErriezDS1302::getTrace(DS1302TraceRecord *records, uint8_t maxRecords)
+{
+    uint8_t count = (_traceCount < maxRecords) ? _traceCount : maxRecords;
+    uint8_t index = (_traceHead + DS1302_TRACE_NUM_RECORDS - count) % DS1302_TRACE_NUM_RECORDS;
+
+    for (uint8_t i = 0; i < count; i++) {
+        records[i] = _trace[index];
+        index = (index + 1) % DS1302_TRACE_NUM_RECORDS;
+    }
+
+    return count;
+}
+
+/*!
+ * \brief Print trace records, oldest first.
+ * \details
+ *      One line per CE session: "DS1302 <start us> <duration us> <cmd> <len> <data>", with
+ *      command and data in hex. Decode with examples/ErriezDS1302Trace/ErriezDS1302Trace.py.
+ * \param out
+ *      Output stream.
+ */
+#ifdef ARDUINO
+void ErriezDS1302::dumpTrace(Print &out)
+#else
+void ErriezDS1302::dumpTrace(FILE *out)
+#endif
+{
+    DS1302TraceRecord record;
+    uint8_t index = (_traceHead + DS1302_TRACE_NUM_RECORDS - _traceCount) % DS1302_TRACE_NUM_RECORDS;
+    char line[40];
+
+    for (uint8_t i = 0; i < _traceCount; i++) {
+        record = _trace[index];
+        index = (index + 1) % DS1302_TRACE_NUM_RECORDS;
+
+        snprintf(line, sizeof(line), "DS1302 %lu %u %02X %u ", (unsigned long)record.start,
+                 record.duration, record.cmd, record.len);
+#ifdef ARDUINO
+        out.print(line);
+#else
+        fputs(line, out);
+#endif
+        for (uint8_t j = 0; (j < record.len) && (j < DS1302_TRACE_NUM_DATA); j++) {
+            snprintf(line, sizeof(line), "%02X", record.data[j]);
+#ifdef ARDUINO
+            out.print(line);
+#else
+            fputs(line, out);
+#endif
+        }
+#ifdef ARDUINO
+        out.println();
+#else
+        fputc('\n', out);
+#endif
+    }
+}
+
+/*!
+ * \brief Clear trace records.
+ */
+void ErriezDS1302::clearTrace()
+{
+    _traceHead = 0;
+    _traceCount = 0;
+}
+
+/*!
+ * \brief Get trace timestamp
+ * \return
+ *      micros(), simulated time or monotonic time in us.
+ */
+uint32_t ErriezDS1302::traceMicros()
+{
+#if defined(DS1302_SIMULATOR)
+    return (uint32_t)(_sim->getTime() / 1000);
+#elif defined(ARDUINO)
+    return micros();
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000000UL + ts.tv_nsec / 1000);
+#endif
+}
+
+/*!
+ * \brief Start trace record of a CE session.
+ */
+void ErriezDS1302::traceBegin()
+{
+    DS1302TraceRecord *record = &_trace[_traceHead];
+
+    record->start = traceMicros();
+    record->cmd = 0;
+    record->len = 0;
+}
+
+/*!
+ * \brief Trace address/command byte.
+ * \param cmd
+ *      Address/command byte.
+ */
+void ErriezDS1302::traceCmd(uint8_t cmd)
+{
+    _trace[_traceHead].cmd = cmd;
+}
+
+/*!
+ * \brief Trace data byte.
+ * \param value
+ *      Data byte written or read.
+ */
+void ErriezDS1302::traceByte(uint8_t value)
+{
+    DS1302TraceRecord *record = &_trace[_traceHead];
+
+    if (record->len < DS1302_TRACE_NUM_DATA) {
+        record->data[record->len] = value;
+    }
+    if (record->len < 0xFF) {
+        record->len++;
+    }
+}
+
+/*!
+ * \brief End trace record of a CE session.
+ */
+void ErriezDS1302::traceEnd()
+{
+    DS1302TraceRecord *record = &_trace[_traceHead];
+    uint32_t duration = traceMicros() - record->start;
+
+    record->duration = (duration > 0xFFFF) ? 0xFFFF : (uint16_t)duration;
+
+    _traceHead = (_traceHead + 1) % DS1302_TRACE_NUM_RECORDS;
+    if (_traceCount < DS1302_TRACE_NUM_RECORDS) {
+        _traceCount++;
+    }
+}
+#endif // DS1302_TRACE
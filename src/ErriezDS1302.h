@@ -33,9 +33,43 @@
 #ifndef ERRIEZ_DS1302_H_
 #define ERRIEZ_DS1302_H_
 
+#if defined(ARDUINO)
 #include <Arduino.h>
+#else
+#include <stdint.h>
+#include <string.h>
+#endif
 #include <time.h>
 
+// Compile-time feature selection: define DS1302_MINIMAL and/or DS1302_FEATURE_xxx=0/1 as build
+// flag. Disabled features are compiled out, raw register access is always available.
+#ifdef DS1302_MINIMAL
+#define DS1302_FEATURE_DEFAULT  0       //!< Minimal profile: raw register core only
+#else
+#define DS1302_FEATURE_DEFAULT  1       //!< Default profile: all features
+#endif
+#ifndef DS1302_FEATURE_TM
+#define DS1302_FEATURE_TM       DS1302_FEATURE_DEFAULT  //!< struct tm date/time functions
+#endif
+#ifndef DS1302_FEATURE_EPOCH
+#define DS1302_FEATURE_EPOCH    DS1302_FEATURE_TM       //!< Unix epoch functions
+#endif
+#ifndef DS1302_FEATURE_RAM
+#define DS1302_FEATURE_RAM      DS1302_FEATURE_DEFAULT  //!< Battery backed RAM functions
+#endif
+#ifndef DS1302_FEATURE_BUS
+#define DS1302_FEATURE_BUS      DS1302_FEATURE_DEFAULT  //!< Shared CLK/IO bus (Arduino)
+#endif
+#if DS1302_FEATURE_EPOCH && !DS1302_FEATURE_TM
+#error "DS1302_FEATURE_EPOCH requires DS1302_FEATURE_TM"
+#endif
+
+#if defined(DS1302_SIMULATOR)
+#include "ErriezDS1302Sim.h"
+#elif !defined(ARDUINO) && defined(__linux__)
+#define DS1302_LINUX_GPIO                                           //!< Linux GPIO character device backend
+#endif
+
 //! DS1302 address/command register
 #define DS1302_ACB              0x80    //!< Address command date/time
 #define DS1302_ACB_RAM          0x40    //!< Address command RAM
@@ -82,6 +116,16 @@
 
 #define DS1302_TCS_DISABLE      0x5C    //!< Tickle Charger disable value
 
+//! beginFast() status flags
+#define DS1302_FAST_PRESENT     0x01    //!< RTC detected
+#define DS1302_FAST_RUNNING     0x02    //!< Oscillator running (CH bit cleared)
+#define DS1302_FAST_VALID       0x04    //!< Date/time registers valid
+#define DS1302_FAST_WARM_BOOT   0x08    //!< Warm-boot flag found in RAM
+#define DS1302_FAST_WP_CLEARED  0x10    //!< Write protect was set and has been cleared
+
+#define DS1302_WARM_BOOT_MAGIC  0xA5    //!< Warm-boot flag value in RAM
+#define DS1302_NO_WARM_BOOT     0xFF    //!< No warm-boot flag
+
 #ifdef __AVR
 #define DS1302_CLK_LOW()        { *portOutputRegister(_clkPort) &= ~_clkBit; }  //!< CLK pin low
 #define DS1302_CLK_HIGH()       { *portOutputRegister(_clkPort) |= _clkBit; }   //!< CLK pin high
@@ -98,6 +142,45 @@
 #define DS1302_CE_HIGH()       { *portOutputRegister(_cePort) |= _ceBit; }   //!< CE pin high
 #define DS1302_CE_INPUT()      { *portModeRegister(_cePort) &= ~_ceBit; }    //!< CE pin input
 #define DS1302_CE_OUTPUT()     { *portModeRegister(_cePort) |= _ceBit; }     //!< CE pin output
+#elif defined(DS1302_LINUX_GPIO)
+// Linux line indexes in the GPIO line request, IO first so a direction change is applied before
+// a CLK edge in the same ioctl
+#define DS1302_LINE_IO          (1 << 0)    //!< IO line mask
+#define DS1302_LINE_CLK         (1 << 1)    //!< CLK line mask
+#define DS1302_LINE_CE          (1 << 2)    //!< CE line mask
+
+// Low levels, data and direction changes are staged and merged into the next CLK edge or read
+#define DS1302_CLK_LOW()        { gpioStage(DS1302_LINE_CLK, false); }      //!< CLK pin low
+#define DS1302_CLK_HIGH()       { gpioClkHigh(); }                          //!< CLK pin high
+#define DS1302_CLK_INPUT()                                                  //!< CLK pin input
+#define DS1302_CLK_OUTPUT()                                                 //!< CLK pin output
+
+#define DS1302_IO_LOW()        { gpioStage(DS1302_LINE_IO, false); }        //!< IO pin low
+#define DS1302_IO_HIGH()       { gpioStage(DS1302_LINE_IO, true); }         //!< IO pin high
+#define DS1302_IO_INPUT()      { gpioDirection(true); }                     //!< IO pin input
+#define DS1302_IO_OUTPUT()     { gpioDirection(false); }                    //!< IO pin output
+#define DS1302_IO_READ()       ( gpioRead() )                               //!< IO pin read
+
+#define DS1302_CE_LOW()        { gpioCe(false); }                           //!< CE pin low
+#define DS1302_CE_HIGH()       { gpioCe(true); }                            //!< CE pin high
+#define DS1302_CE_INPUT()                                                   //!< CE pin input
+#define DS1302_CE_OUTPUT()                                                  //!< CE pin output
+#elif defined(DS1302_SIMULATOR)
+#define DS1302_CLK_LOW()        { _sim->pinWrite(DS1302_SIM_CLK, false); }  //!< CLK pin low
+#define DS1302_CLK_HIGH()       { _sim->pinWrite(DS1302_SIM_CLK, true); }   //!< CLK pin high
+#define DS1302_CLK_INPUT()      { _sim->pinMode(DS1302_SIM_CLK, true); }    //!< CLK pin input
+#define DS1302_CLK_OUTPUT()     { _sim->pinMode(DS1302_SIM_CLK, false); }   //!< CLK pin output
+
+#define DS1302_IO_LOW()        { _sim->pinWrite(DS1302_SIM_IO, false); }    //!< IO pin low
+#define DS1302_IO_HIGH()       { _sim->pinWrite(DS1302_SIM_IO, true); }     //!< IO pin high
+#define DS1302_IO_INPUT()      { _sim->pinMode(DS1302_SIM_IO, true); }      //!< IO pin input
+#define DS1302_IO_OUTPUT()     { _sim->pinMode(DS1302_SIM_IO, false); }     //!< IO pin output
+#define DS1302_IO_READ()       ( _sim->pinRead() )                          //!< IO pin read
+
+#define DS1302_CE_LOW()        { _sim->pinWrite(DS1302_SIM_CE, false); }    //!< CE pin low
+#define DS1302_CE_HIGH()       { _sim->pinWrite(DS1302_SIM_CE, true); }     //!< CE pin high
+#define DS1302_CE_INPUT()      { _sim->pinMode(DS1302_SIM_CE, true); }      //!< CE pin input
+#define DS1302_CE_OUTPUT()     { _sim->pinMode(DS1302_SIM_CE, false); }     //!< CE pin output
 #else
 #define DS1302_CLK_LOW()        { digitalWrite(_clkPin, LOW); }     //!< CLK pin low
 #define DS1302_CLK_HIGH()       { digitalWrite(_clkPin, HIGH); }    //!< CLK pin high
@@ -117,12 +200,51 @@
 #endif
 
 // Delay defines
-#if F_CPU >= 20000000UL
+#if defined(DS1302_SIMULATOR)
+#define DS1302_PIN_DELAY()      { _sim->pinDelay(); }               //!< Delay between pin changes
+#elif F_CPU >= 20000000UL
 #define DS1302_PIN_DELAY()      { delayMicroseconds(1); }           //!< Delay between pin changes
 #else
 #define DS1302_PIN_DELAY()                                          //!< Delay between pin changes
 #endif
 
+#ifdef DS1302_TRACE
+#ifndef ARDUINO
+#include <stdio.h>
+#endif
+
+//! Number of CE sessions in the trace ring
+#ifndef DS1302_TRACE_NUM_RECORDS
+#define DS1302_TRACE_NUM_RECORDS    16
+#endif
+//! Number of data bytes stored per CE session
+#ifndef DS1302_TRACE_NUM_DATA
+#define DS1302_TRACE_NUM_DATA       8
+#endif
+
+//! Trace record of one CE session
+struct DS1302TraceRecord {
+    uint32_t start;                             //!< Start time in us
+    uint16_t duration;                          //!< Duration in us
+    uint8_t cmd;                                //!< Address/command byte
+    uint8_t len;                                //!< Number of data bytes transferred
+    uint8_t data[DS1302_TRACE_NUM_DATA];        //!< First data bytes
+};
+
+#define DS1302_TRACE_BEGIN()        traceBegin()        //!< Trace CE session start
+#define DS1302_TRACE_CMD(cmd)       traceCmd(cmd)       //!< Trace address/command byte
+#define DS1302_TRACE_BYTE(value)    traceByte(value)    //!< Trace data byte
+#define DS1302_TRACE_END()          traceEnd()          //!< Trace CE session end
+#else
+#define DS1302_TRACE_BEGIN()                            //!< Trace disabled
+#define DS1302_TRACE_CMD(cmd)                           //!< Trace disabled
+#define DS1302_TRACE_BYTE(value)                        //!< Trace disabled
+#define DS1302_TRACE_END()                              //!< Trace disabled
+#endif
+
+#if defined(ARDUINO) && DS1302_FEATURE_BUS
+class ErriezDS1302Bus;
+#endif
 
 //! DS1302 RTC class
 class ErriezDS1302
@@ -130,25 +252,47 @@ class ErriezDS1302
 public:
     // Constructor
     ErriezDS1302(uint8_t clkPin, uint8_t ioPin, uint8_t cePin);
+#if defined(ARDUINO) && DS1302_FEATURE_BUS
+    ErriezDS1302(ErriezDS1302Bus *bus, uint8_t cePin);
+#endif
+#ifdef DS1302_LINUX_GPIO
+    ErriezDS1302(const char *chipPath, uint8_t clkLine, uint8_t ioLine, uint8_t ceLine);
+    ~ErriezDS1302();
+#endif
+#ifdef DS1302_SIMULATOR
+    ErriezDS1302(ErriezDS1302Sim *sim);
+#endif
     bool begin();
+#if DS1302_FEATURE_TM
+    uint8_t beginFast(struct tm *dt=NULL, uint8_t warmBootAddr=DS1302_NO_WARM_BOOT);
+#endif
 
     // Oscillator functions
     bool isRunning();
     bool clockEnable(bool enable=true);
 
     // Set/get date/time
+#if DS1302_FEATURE_EPOCH
     time_t getEpoch();
     bool setEpoch(time_t t);
+#endif
+#if DS1302_FEATURE_TM
     bool read(struct tm *dt);
     bool write(const struct tm *dt);
+#endif
     bool setTime(uint8_t hour, uint8_t min, uint8_t sec);
+    bool setDate(uint8_t mday, uint8_t mon, uint16_t year, uint8_t wday);
+    bool setField(uint8_t reg, uint16_t value);
     bool getTime(uint8_t *hour, uint8_t *min, uint8_t *sec);
+    bool getSecondsOfDay(uint32_t *seconds);
+#if DS1302_FEATURE_TM
     bool setDateTime(uint8_t hour, uint8_t min, uint8_t sec,
                      uint8_t mday, uint8_t mon, uint16_t year,
                      uint8_t wday);
     bool getDateTime(uint8_t *hour, uint8_t *min, uint8_t *sec,
                      uint8_t *mday, uint8_t *mon, uint16_t *year,
                      uint8_t *wday);
+#endif
 
     // BCD conversions
     uint8_t bcdToDec(uint8_t bcd);
@@ -160,13 +304,33 @@ public:
 
     // Read/write buffer
     bool readBuffer(uint8_t reg, void *buffer, uint8_t len);
-    bool writeBuffer(uint8_t reg, void *buffer, uint8_t len);
+    bool writeBuffer(uint8_t reg, const void *buffer, uint8_t len);
 
+#if DS1302_FEATURE_RAM
     void writeByteRAM(uint8_t addr, uint8_t value);
     void writeBufferRAM(uint8_t *buf, uint8_t len);
 
     uint8_t readByteRAM(uint8_t addr);
     void readBufferRAM(uint8_t *buf, uint8_t len);
+#endif
+
+#ifdef DS1302_LINUX_GPIO
+    // Linux GPIO backend
+    void end();
+    uint32_t getSyscallCount();
+    uint32_t getTransferSyscallCount();
+#endif
+
+#ifdef DS1302_TRACE
+    // Bus transaction trace
+    uint8_t getTrace(DS1302TraceRecord *records, uint8_t maxRecords);
+#ifdef ARDUINO
+    void dumpTrace(Print &out);
+#else
+    void dumpTrace(FILE *out);
+#endif
+    void clearTrace();
+#endif
 
 private:
 #ifdef __AVR
@@ -183,9 +347,60 @@ private:
     uint8_t _cePin;     //!< Chip enable pin
 #endif
 
+#if defined(ARDUINO) && DS1302_FEATURE_BUS
+    friend class ErriezDS1302Bus;
+    ErriezDS1302Bus *_bus;          //!< Shared CLK/IO bus, or NULL
+#endif
+
+#ifdef DS1302_SIMULATOR
+    ErriezDS1302Sim *_sim;          //!< Simulated chip
+#endif
+
+#ifdef DS1302_LINUX_GPIO
+    const char *_chipPath;          //!< GPIO character device path
+    int _lineFd;                    //!< GPIO line request file descriptor
+    uint8_t _lineValues;            //!< Staged line values
+    uint8_t _lineActual;            //!< Line values written to the kernel
+    bool _ioInput;                  //!< Staged IO line direction is input
+    bool _ioInputActual;            //!< IO line configured as input in the kernel
+    bool _lineError;                //!< An ioctl of the current transfer failed
+    uint32_t _syscalls;             //!< Number of GPIO ioctls since begin()
+    uint32_t _transferStart;        //!< Number of GPIO ioctls at start of transfer
+    uint32_t _transferSyscalls;     //!< Number of GPIO ioctls of the last transfer
+
+    bool gpioOpen();
+    bool gpioConfigure();
+    void gpioStage(uint8_t mask, bool high);
+    void gpioFlush();
+    void gpioClkHigh();
+    void gpioCe(bool high);
+    void gpioDirection(bool input);
+    bool gpioRead();
+#endif
+
+#ifdef DS1302_TRACE
+    DS1302TraceRecord _trace[DS1302_TRACE_NUM_RECORDS]; //!< Trace ring
+    uint8_t _traceHead;                                 //!< Next record in the ring
+    uint8_t _traceCount;                                //!< Number of valid records
+
+    uint32_t traceMicros();
+    void traceBegin();
+    void traceCmd(uint8_t cmd);
+    void traceByte(uint8_t value);
+    void traceEnd();
+#endif
+
+#if DS1302_FEATURE_TM
+    // Date/time conversion
+    bool decodeClock(const uint8_t *buffer, struct tm *dt);
+#endif
+
     // RTC interface functions
+    bool initPins();
+    void waitDateRollover();
+    void initCe();
     void transferBegin();
-    void transferEnd();
+    bool transferEnd();
     void writeAddrCmd(uint8_t value);
     void writeByte(uint8_t value);
     uint8_t readByte();
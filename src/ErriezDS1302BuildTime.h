@@ -0,0 +1,201 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \file ErriezDS1302BuildTime.h
+ * \brief Compile time conversion of the build date/time to DS1302 RTC clock registers
+ * \details
+ *      Source:         https://github.com/Erriez/ErriezDS1302
+ *      Documentation:  https://erriez.github.io/ErriezDS1302
+ *
+ *      __DATE__ ("Mmm dd yyyy") and __TIME__ ("hh:mm:ss") are converted by the compiler, so no
+ *      parsing code or month name table is stored in flash.
+ */
+
+#ifndef ERRIEZ_DS1302_BUILD_TIME_H_
+#define ERRIEZ_DS1302_BUILD_TIME_H_
+
+#include "ErriezDS1302.h"
+
+/*!
+ * \brief Initializer of an 8-byte clock burst block with the build date/time
+ * \details
+ *      Register order seconds, minutes, hours (24-hour), day of the month, month, day of the
+ *      week, year and write protect (cleared). Write with writeBuffer(0, block, 8).
+ */
+#define DS1302_BUILD_TIME_BLOCK { \
+    ErriezDS1302BuildTime::seconds(__TIME__), \
+    ErriezDS1302BuildTime::minutes(__TIME__), \
+    ErriezDS1302BuildTime::hours(__TIME__), \
+    ErriezDS1302BuildTime::dayMonth(__DATE__), \
+    ErriezDS1302BuildTime::month(__DATE__), \
+    ErriezDS1302BuildTime::dayWeek(__DATE__), \
+    ErriezDS1302BuildTime::year(__DATE__), \
+    0x00 \
+}
+
+//! Build date/time to DS1302 register conversion, evaluated at compile time
+class ErriezDS1302BuildTime
+{
+public:
+    /*!
+     * \brief Seconds register
+     * \param t
+     *      __TIME__ string.
+     * \return
+     *      BCD seconds, CH bit cleared.
+     */
+    static constexpr uint8_t seconds(const char *t)
+    {
+        return bcd(t[6], t[7]);
+    }
+
+    /*!
+     * \brief Minutes register
+     * \param t
+     *      __TIME__ string.
+     * \return
+     *      BCD minutes.
+     */
+    static constexpr uint8_t minutes(const char *t)
+    {
+        return bcd(t[3], t[4]);
+    }
+
+    /*!
+     * \brief Hours register
+     * \param t
+     *      __TIME__ string.
+     * \return
+     *      BCD hours, 24-hour mode.
+     */
+    static constexpr uint8_t hours(const char *t)
+    {
+        return bcd(t[0], t[1]);
+    }
+
+    /*!
+     * \brief Day of the month register
+     * \param d
+     *      __DATE__ string, day of the month is space padded.
+     * \return
+     *      BCD day of the month 1..31.
+     */
+    static constexpr uint8_t dayMonth(const char *d)
+    {
+        return bcd(d[4], d[5]);
+    }
+
+    /*!
+     * \brief Month register
+     * \param d
+     *      __DATE__ string.
+     * \return
+     *      BCD month 1..12.
+     */
+    static constexpr uint8_t month(const char *d)
+    {
+        return decToBcd(monthNumber(d));
+    }
+
+    /*!
+     * \brief Day of the week register
+     * \param d
+     *      __DATE__ string.
+     * \return
+     *      Day of the week 1..7 (1=Sunday).
+     */
+    static constexpr uint8_t dayWeek(const char *d)
+    {
+        return weekday(yearNumber(d) - (monthNumber(d) < 3), monthNumber(d),
+                       digit(d[4]) * 10 + digit(d[5])) + 1;
+    }
+
+    /*!
+     * \brief Year register
+     * \param d
+     *      __DATE__ string, year 2000..2099.
+     * \return
+     *      BCD year 0..99.
+     */
+    static constexpr uint8_t year(const char *d)
+    {
+        return bcd(d[9], d[10]);
+    }
+
+    /*!
+     * \brief Year number
+     * \param d
+     *      __DATE__ string.
+     * \return
+     *      Year, for example 2020.
+     */
+    static constexpr uint16_t yearNumber(const char *d)
+    {
+        return digit(d[7]) * 1000 + digit(d[8]) * 100 + digit(d[9]) * 10 + digit(d[10]);
+    }
+
+    /*!
+     * \brief Month number
+     * \param d
+     *      __DATE__ string.
+     * \return
+     *      Month 1..12 (1=January).
+     */
+    static constexpr uint8_t monthNumber(const char *d)
+    {
+        return (d[0] == 'J') ? ((d[1] == 'a') ? 1 : ((d[2] == 'n') ? 6 : 7)) :
+               (d[0] == 'F') ? 2 :
+               (d[0] == 'M') ? ((d[2] == 'r') ? 3 : 5) :
+               (d[0] == 'A') ? ((d[1] == 'p') ? 4 : 8) :
+               (d[0] == 'S') ? 9 :
+               (d[0] == 'O') ? 10 :
+               (d[0] == 'N') ? 11 : 12;
+    }
+
+private:
+    static constexpr uint8_t digit(char c)
+    {
+        return (c == ' ') ? 0 : (uint8_t)(c - '0');
+    }
+
+    static constexpr uint8_t bcd(char high, char low)
+    {
+        return (uint8_t)((digit(high) << 4) | digit(low));
+    }
+
+    static constexpr uint8_t decToBcd(uint8_t dec)
+    {
+        return (uint8_t)(((dec / 10) << 4) | (dec % 10));
+    }
+
+    // Sakamoto's algorithm, y is the year minus one for January and February
+    static constexpr uint8_t weekday(uint16_t y, uint8_t m, uint8_t d)
+    {
+        return (uint8_t)((y + y / 4 - y / 100 + y / 400 +
+                          "\0\3\2\5\0\3\5\1\4\6\2\4"[m - 1] + d) % 7);
+    }
+};
+
+#endif // ERRIEZ_DS1302_BUILD_TIME_H_
@@ -0,0 +1,131 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \file ErriezDS1302Bus.cpp
+ * \brief Shared CLK/IO bus for multiple DS1302 RTC's with a CE pin per chip
+ * \details
+ *      Source:         https://github.com/Erriez/ErriezDS1302
+ *      Documentation:  https://erriez.github.io/ErriezDS1302
+ */
+
+#include "ErriezDS1302Bus.h"
+
+#if defined(ARDUINO) && DS1302_FEATURE_BUS
+
+/*!
+ * \brief Constructor shared bus.
+ * \details
+ *      The bus owns the CLK and IO pins. Create a device per chip with
+ *      ErriezDS1302(&bus, cePin).
+ * \param clkPin
+ *      Clock pin
+ * \param ioPin
+ *      I/O pin.
+ */
+ErriezDS1302Bus::ErriezDS1302Bus(uint8_t clkPin, uint8_t ioPin) :
+        _clkPin(clkPin), _ioPin(ioPin), _initialized(false), _ioInput(false), _numDevices(0)
+{
+}
+
+/*!
+ * \brief Attach device to the bus.
+ * \details
+ *      The CE pin of the device is driven low immediately. Attach all devices before calling
+ *      begin() of any device, otherwise a floating CE pin may select a chip during a transfer to
+ *      another chip.
+ * \param rtc
+ *      Device created with ErriezDS1302(&bus, cePin).
+ * \retval true
+ *      Success.
+ * \retval false
+ *      Device belongs to another bus, or the bus is full.
+ */
+bool ErriezDS1302Bus::attach(ErriezDS1302 *rtc)
+{
+    if ((rtc->_bus != this) || (_numDevices >= DS1302_BUS_MAX_DEVICES)) {
+        return false;
+    }
+
+    rtc->initCe();
+    _devices[_numDevices++] = rtc;
+
+    return true;
+}
+
+/*!
+ * \brief Get number of attached devices.
+ * \return
+ *      Number of devices.
+ */
+uint8_t ErriezDS1302Bus::getNumDevices()
+{
+    return _numDevices;
+}
+
+#if DS1302_FEATURE_TM
+/*!
+ * \brief Read date and time of all attached devices.
+ * \details
+ *      The clock registers of all devices are read back-to-back in attach order first and
+ *      converted afterwards, to minimize the skew between the samples.
+ * \param dt
+ *      Array of getNumDevices() date/time struct tm's.
+ * \return
+ *      Number of devices with valid date/time. Invalid entries are cleared.
+ */
+uint8_t ErriezDS1302Bus::readAll(struct tm *dt)
+{
+    uint8_t buffer[DS1302_BUS_MAX_DEVICES][DS1302_NUM_CLOCK_REGS];
+    ErriezDS1302 *rtc;
+    bool transferOk[DS1302_BUS_MAX_DEVICES];
+    uint8_t numValid = 0;
+    uint8_t i;
+    uint8_t j;
+
+    // Burst read clock registers of all devices
+    for (i = 0; i < _numDevices; i++) {
+        rtc = _devices[i];
+        rtc->transferBegin();
+        rtc->writeAddrCmd(DS1302_CMD_READ_CLOCK_BURST);
+        for (j = 0; j < DS1302_NUM_CLOCK_REGS; j++) {
+            buffer[i][j] = rtc->readByte();
+        }
+        transferOk[i] = rtc->transferEnd();
+    }
+
+    // Convert BCD registers to date/time
+    for (i = 0; i < _numDevices; i++) {
+        if (transferOk[i] && _devices[i]->decodeClock(buffer[i], &dt[i])) {
+            numValid++;
+        } else {
+            memset(&dt[i], 0, sizeof(struct tm));
+        }
+    }
+
+    return numValid;
+}
+#endif // DS1302_FEATURE_TM
+
+#endif // ARDUINO
@@ -0,0 +1,75 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \file ErriezDS1302Bus.h
+ * \brief Shared CLK/IO bus for multiple DS1302 RTC's with a CE pin per chip
+ * \details
+ *      Source:         https://github.com/Erriez/ErriezDS1302
+ *      Documentation:  https://erriez.github.io/ErriezDS1302
+ */
+
+#ifndef ERRIEZ_DS1302_BUS_H_
+#define ERRIEZ_DS1302_BUS_H_
+
+#include "ErriezDS1302.h"
+
+#if defined(ARDUINO) && DS1302_FEATURE_BUS
+
+//! Maximum number of devices on a bus
+#ifndef DS1302_BUS_MAX_DEVICES
+#define DS1302_BUS_MAX_DEVICES  8
+#endif
+
+//! DS1302 shared bus class
+class ErriezDS1302Bus
+{
+public:
+    // Constructor
+    ErriezDS1302Bus(uint8_t clkPin, uint8_t ioPin);
+
+    // Devices
+    bool attach(ErriezDS1302 *rtc);
+    uint8_t getNumDevices();
+
+#if DS1302_FEATURE_TM
+    // Read clocks of all devices
+    uint8_t readAll(struct tm *dt);
+#endif
+
+private:
+    friend class ErriezDS1302;
+
+    uint8_t _clkPin;                                    //!< Clock pin
+    uint8_t _ioPin;                                     //!< Data pin
+    bool _initialized;                                  //!< CLK and IO pins initialized
+    bool _ioInput;                                      //!< IO pin is input
+
+    ErriezDS1302 *_devices[DS1302_BUS_MAX_DEVICES];     //!< Attached devices
+    uint8_t _numDevices;                                //!< Number of attached devices
+};
+
+#endif // ARDUINO
+
+#endif // ERRIEZ_DS1302_BUS_H_
@@ -0,0 +1,268 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \file ErriezDS1302Coalesce.cpp
+ * \brief Request coalescing front-end for concurrent DS1302 RTC access from multiple threads
+ * \details
+ *      Source:         https://github.com/Erriez/ErriezDS1302
+ *      Documentation:  https://erriez.github.io/ErriezDS1302
+ *
+ *      The first thread which requests a read while the bus is idle becomes the leader and
+ *      issues the clock burst without holding the mutex. Threads requesting a read while this
+ *      burst is in flight wait for it and receive its result instead of issuing their own
+ *      transfer. Writes have priority: no new read burst starts while a write is waiting, and a
+ *      write invalidates the cached result.
+ */
+
+#include "ErriezDS1302Coalesce.h"
+
+#if (defined(ARDUINO_ARCH_ESP32) || !defined(ARDUINO)) && DS1302_FEATURE_TM
+
+/*!
+ * \brief Constructor coalescing front-end.
+ * \param rtc
+ *      Initialized RTC object. All RTC access must go through this object.
+ * \param freshnessMs
+ *      Reads within this window after a clock burst are served from the last result, 0 to
+ *      coalesce only reads which overlap with a burst in flight. The time returned from cache
+ *      may be behind by this window.
+ */
+ErriezDS1302Coalesce::ErriezDS1302Coalesce(ErriezDS1302 *rtc, uint32_t freshnessMs) :
+        _rtc(rtc), _freshnessMs(freshnessMs), _busBusy(false), _readInFlight(false),
+        _writersWaiting(0), _generation(0), _dtValid(false), _cacheValid(false), _cacheTime(0)
+{
+    pthread_mutex_init(&_mutex, NULL);
+    pthread_cond_init(&_cond, NULL);
+    memset(&_dt, 0, sizeof(_dt));
+    memset(&_metrics, 0, sizeof(_metrics));
+}
+
+/*!
+ * \brief Destructor.
+ */
+ErriezDS1302Coalesce::~ErriezDS1302Coalesce()
+{
+    pthread_cond_destroy(&_cond);
+    pthread_mutex_destroy(&_mutex);
+}
+
+/*!
+ * \brief Set freshness window.
+ * \param freshnessMs
+ *      Cache window in ms, 0 to disable the cache.
+ */
+void ErriezDS1302Coalesce::setFreshness(uint32_t freshnessMs)
+{
+    pthread_mutex_lock(&_mutex);
+    _freshnessMs = freshnessMs;
+    pthread_mutex_unlock(&_mutex);
+}
+
+/*!
+ * \brief Read date and time, thread safe.
+ * \param dt
+ *      Date/time struct tm.
+ * \retval true
+ *      Success.
+ * \retval false
+ *      Invalid date/time in RTC registers.
+ */
+bool ErriezDS1302Coalesce::read(struct tm *dt)
+{
+    struct tm result;
+    bool ok;
+
+    pthread_mutex_lock(&_mutex);
+    _metrics.requests++;
+
+    for (;;) {
+        if (_cacheValid && !_writersWaiting && ((timeMs() - _cacheTime) <= _freshnessMs)) {
+            // Serve from the last burst
+            _metrics.cacheHits++;
+            break;
+        }
+
+        if (_readInFlight) {
+            // Wait for the burst of the leader and take its result
+            uint32_t generation = _generation;
+            while (_generation == generation) {
+                pthread_cond_wait(&_cond, &_mutex);
+            }
+            _metrics.coalesced++;
+            break;
+        }
+
+        if (!_busBusy && !_writersWaiting) {
+            // Leader: issue the burst without holding the mutex
+            _busBusy = true;
+            _readInFlight = true;
+            pthread_mutex_unlock(&_mutex);
+
+            ok = _rtc->read(&result);
+
+            pthread_mutex_lock(&_mutex);
+            _dt = result;
+            _dtValid = ok;
+            _cacheValid = ok && (_freshnessMs != 0);
+            _cacheTime = timeMs();
+            _generation++;
+            _readInFlight = false;
+            _busBusy = false;
+            _metrics.transfers++;
+            pthread_cond_broadcast(&_cond);
+            break;
+        }
+
+        // Bus busy with a write, or a write has priority
+        pthread_cond_wait(&_cond, &_mutex);
+    }
+
+    *dt = _dt;
+    ok = _dtValid;
+    pthread_mutex_unlock(&_mutex);
+
+    return ok;
+}
+
+/*!
+ * \brief Read Unix epoch UTC, thread safe.
+ * \details
+ *      Same conversion as ErriezDS1302::getEpoch().
+ * \return
+ *      Unix epoch time_t seconds since 1970, 0 on failure.
+ */
+time_t ErriezDS1302Coalesce::getEpoch()
+{
+    struct tm dt;
+
+    if (!read(&dt)) {
+        return 0;
+    }
+
+    // Convert date/time struct tm to time_t
+    return mktime(&dt);
+}
+
+/*!
+ * \brief Write date and time, thread safe.
+ * \details
+ *      Waits only for the transfer on the bus, then goes before reads which have not started
+ *      their burst yet.
+ * \param dt
+ *      Date/time struct tm.
+ * \retval true
+ *      Success.
+ * \retval false
+ *      Write failed.
+ */
+bool ErriezDS1302Coalesce::write(const struct tm *dt)
+{
+    bool ok;
+
+    pthread_mutex_lock(&_mutex);
+    _metrics.requests++;
+    _metrics.writes++;
+
+    _writersWaiting++;
+    while (_busBusy) {
+        pthread_cond_wait(&_cond, &_mutex);
+    }
+    _writersWaiting--;
+    _busBusy = true;
+    _cacheValid = false;
+    pthread_mutex_unlock(&_mutex);
+
+    ok = _rtc->write(dt);
+
+    pthread_mutex_lock(&_mutex);
+    _busBusy = false;
+    _metrics.transfers++;
+    pthread_cond_broadcast(&_cond);
+    pthread_mutex_unlock(&_mutex);
+
+    return ok;
+}
+
+/*!
+ * \brief Write Unix epoch UTC, thread safe.
+ * \details
+ *      Same conversion as ErriezDS1302::setEpoch(), with the reentrant gmtime_r().
+ * \param t
+ *      time_t time
+ * \retval true
+ *      Success.
+ * \retval false
+ *      Write failed.
+ */
+bool ErriezDS1302Coalesce::setEpoch(time_t t)
+{
+    struct tm dt;
+
+    // Convert time_t to date/time struct tm
+    gmtime_r(&t, &dt);
+
+    return write(&dt);
+}
+
+/*!
+ * \brief Get metrics.
+ * \param metrics
+ *      Copy of the metrics.
+ */
+void ErriezDS1302Coalesce::getMetrics(DS1302CoalesceMetrics *metrics)
+{
+    pthread_mutex_lock(&_mutex);
+    *metrics = _metrics;
+    pthread_mutex_unlock(&_mutex);
+}
+
+/*!
+ * \brief Reset metrics.
+ */
+void ErriezDS1302Coalesce::resetMetrics()
+{
+    pthread_mutex_lock(&_mutex);
+    memset(&_metrics, 0, sizeof(_metrics));
+    pthread_mutex_unlock(&_mutex);
+}
+
+/*!
+ * \brief Get monotonic time
+ * \return
+ *      Time in ms.
+ */
+uint32_t ErriezDS1302Coalesce::timeMs()
+{
+#ifdef ARDUINO
+    return millis();
+#else
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(ts.tv_sec * 1000UL + ts.tv_nsec / 1000000UL);
+#endif
+}
+
+#endif // (ARDUINO_ARCH_ESP32 || !ARDUINO) && DS1302_FEATURE_TM
@@ -0,0 +1,97 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \file ErriezDS1302Coalesce.h
+ * \brief Request coalescing front-end for concurrent DS1302 RTC access from multiple threads
+ * \details
+ *      Source:         https://github.com/Erriez/ErriezDS1302
+ *      Documentation:  https://erriez.github.io/ErriezDS1302
+ *
+ *      Available with pthreads: ESP32 (FreeRTOS tasks) and host builds.
+ */
+
+#ifndef ERRIEZ_DS1302_COALESCE_H_
+#define ERRIEZ_DS1302_COALESCE_H_
+
+#include "ErriezDS1302.h"
+
+#if (defined(ARDUINO_ARCH_ESP32) || !defined(ARDUINO)) && DS1302_FEATURE_TM
+
+#include <pthread.h>
+
+//! Coalescing metrics
+struct DS1302CoalesceMetrics {
+    uint32_t requests;      //!< Number of read and write requests
+    uint32_t transfers;     //!< Number of clock bursts on the bus
+    uint32_t coalesced;     //!< Reads served by a burst in flight of another thread
+    uint32_t cacheHits;     //!< Reads served within the freshness window
+    uint32_t writes;        //!< Number of write requests
+};
+
+//! DS1302 RTC request coalescing class
+class ErriezDS1302Coalesce
+{
+public:
+    // Constructor
+    ErriezDS1302Coalesce(ErriezDS1302 *rtc, uint32_t freshnessMs=0);
+    ~ErriezDS1302Coalesce();
+
+    void setFreshness(uint32_t freshnessMs);
+
+    // Thread safe RTC access
+    bool read(struct tm *dt);
+    time_t getEpoch();
+    bool write(const struct tm *dt);
+    bool setEpoch(time_t t);
+
+    // Metrics
+    void getMetrics(DS1302CoalesceMetrics *metrics);
+    void resetMetrics();
+
+private:
+    ErriezDS1302 *_rtc;                                 //!< RTC
+
+    pthread_mutex_t _mutex;                             //!< Protects all members below
+    pthread_cond_t _cond;                               //!< Signals end of a bus transfer
+
+    uint32_t _freshnessMs;                              //!< Cache freshness window
+    bool _busBusy;                                      //!< Bus transfer in progress
+    bool _readInFlight;                                 //!< Clock burst read in progress
+    uint16_t _writersWaiting;                           //!< Writes waiting for the bus
+    uint32_t _generation;                               //!< Completed clock burst reads
+
+    struct tm _dt;                                      //!< Result of the last clock burst
+    bool _dtValid;                                      //!< Last clock burst succeeded
+    bool _cacheValid;                                   //!< _dt may be served from cache
+    uint32_t _cacheTime;                                //!< Time of the last burst in ms
+
+    DS1302CoalesceMetrics _metrics;                     //!< Metrics
+
+    uint32_t timeMs();
+};
+
+#endif // (ARDUINO_ARCH_ESP32 || !ARDUINO) && DS1302_FEATURE_TM
+
+#endif // ERRIEZ_DS1302_COALESCE_H_
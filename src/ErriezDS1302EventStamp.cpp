@@ -0,0 +1,237 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \file ErriezDS1302EventStamp.cpp
+ * \brief ISR safe event timestamping with DS1302 RTC wall-clock time
+ * \details
+ *      Source:         https://github.com/Erriez/ErriezDS1302
+ *      Documentation:  https://erriez.github.io/ErriezDS1302
+ *
+ *      The interrupt handler only stores micros() in a lock-free queue. The main loop keeps an
+ *      anchor which pairs an RTC seconds change with micros(), and converts the queued
+ *      micros() values to epoch with milliseconds relative to this anchor.
+ */
+
+#include "ErriezDS1302EventStamp.h"
+
+#if defined(ARDUINO) && DS1302_FEATURE_EPOCH
+
+/*!
+ * \brief Constructor event timestamp.
+ * \param rtc
+ *      Initialized RTC object.
+ */
+ErriezDS1302EventStamp::ErriezDS1302EventStamp(ErriezDS1302 *rtc) :
+        _rtc(rtc), _head(0), _tail(0), _dropped(0), _anchorValid(false), _lastValid(false)
+{
+}
+
+/*!
+ * \brief Wait for the next RTC seconds change and set the anchor.
+ * \details
+ *      Blocks for up to DS1302_EVENT_SYNC_TIMEOUT ms.
+ * \retval true
+ *      Anchor set.
+ * \retval false
+ *      No seconds change detected. RTC not running?
+ */
+bool ErriezDS1302EventStamp::sync()
+{
+    unsigned long start = millis();
+
+    _lastValid = false;
+    while ((millis() - start) < DS1302_EVENT_SYNC_TIMEOUT) {
+        if (update()) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*!
+ * \brief Update the anchor on an RTC seconds change.
+ * \details
+ *      Call as often as possible from the main loop. Each call reads the seconds register. The
+ *      anchor error is the time between two calls around the seconds change.
+ * \retval true
+ *      Seconds change detected, anchor updated.
+ * \retval false
+ *      No seconds change.
+ */
+bool ErriezDS1302EventStamp::update()
+{
+    uint8_t seconds;
+    uint32_t us;
+    time_t t;
+
+    seconds = _rtc->readRegister(DS1302_REG_SECONDS);
+    us = micros();
+
+    if (!_lastValid || (seconds == _lastSeconds)) {
+        _lastSeconds = seconds;
+        _lastValid = true;
+        return false;
+    }
+    _lastSeconds = seconds;
+
+    // Read date/time belonging to this seconds change
+    t = _rtc->getEpoch();
+    if ((t == 0) || ((uint8_t)(t % 60) != _rtc->bcdToDec(seconds & 0x7F))) {
+        // Read failed or seconds changed again
+        return false;
+    }
+
+    _anchorEpoch = t;
+    _anchorMicros = us;
+    _anchorValid = true;
+
+    return true;
+}
+
+/*!
+ * \brief Check anchor.
+ * \retval true
+ *      Events can be converted.
+ * \retval false
+ *      Call sync() or update() first.
+ */
+bool ErriezDS1302EventStamp::isSynchronized()
+{
+    return _anchorValid;
+}
+
+/*!
+ * \brief Remove oldest event from the queue and convert it to wall-clock time.
+ * \param t
+ *      Unix epoch UTC.
+ * \param ms
+ *      Milliseconds 0..999.
+ * \retval true
+ *      Event returned.
+ * \retval false
+ *      Queue empty, or not synchronized. Events stay queued until synchronized.
+ */
+bool ErriezDS1302EventStamp::pop(time_t *t, uint16_t *ms)
+{
+    uint8_t tail = _tail;
+    uint32_t us;
+
+    if (!_anchorValid || (tail == __atomic_load_n(&_head, __ATOMIC_ACQUIRE))) {
+        return false;
+    }
+
+    us = _queue[tail];
+    __atomic_store_n(&_tail, (uint8_t)((tail + 1) & DS1302_EVENT_QUEUE_MASK), __ATOMIC_RELEASE);
+
+    return convert(us, t, ms);
+}
+
+/*!
+ * \brief Get number of queued events.
+ * \return
+ *      Number of events.
+ */
+uint8_t ErriezDS1302EventStamp::available()
+{
+    return (__atomic_load_n(&_head, __ATOMIC_ACQUIRE) - _tail) & DS1302_EVENT_QUEUE_MASK;
+}
+
+/*!
+ * \brief Get number of events dropped on a full queue.
+ * \details
+ *      The 16-bit counter is written by stamp(), so it is read with interrupts disabled to
+ *      prevent a torn read on 8-bit targets. Call from the main loop.
+ * \return
+ *      Number of dropped events.
+ */
+uint16_t ErriezDS1302EventStamp::getDropped()
+{
+    uint16_t dropped;
+
+    noInterrupts();
+    dropped = _dropped;
+    interrupts();
+
+    return dropped;
+}
+
+/*!
+ * \brief Get current wall-clock time without reading the RTC.
+ * \param t
+ *      Unix epoch UTC.
+ * \param ms
+ *      Milliseconds 0..999.
+ * \retval true
+ *      Success.
+ * \retval false
+ *      Not synchronized.
+ */
+bool ErriezDS1302EventStamp::now(time_t *t, uint16_t *ms)
+{
+    return convert(micros(), t, ms);
+}
+
+/*!
+ * \brief Convert micros() value to wall-clock time.
+ * \details
+ *      The micros() value must be within about 35 minutes of the anchor.
+ * \param us
+ *      micros() value.
+ * \param t
+ *      Unix epoch UTC.
+ * \param ms
+ *      Milliseconds 0..999.
+ * \retval true
+ *      Success.
+ * \retval false
+ *      Not synchronized.
+ */
+bool ErriezDS1302EventStamp::convert(uint32_t us, time_t *t, uint16_t *ms)
+{
+    int32_t delta;
+    int32_t secs;
+    int32_t rem;
+
+    if (!_anchorValid) {
+        return false;
+    }
+
+    // Events may be stamped before the last anchor update
+    delta = (int32_t)(us - _anchorMicros);
+    secs = delta / 1000000L;
+    rem = delta % 1000000L;
+    if (rem < 0) {
+        rem += 1000000L;
+        secs--;
+    }
+
+    *t = _anchorEpoch + secs;
+    *ms = (uint16_t)(rem / 1000);
+
+    return true;
+}
+
+#endif // ARDUINO && DS1302_FEATURE_EPOCH
@@ -0,0 +1,115 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \file ErriezDS1302EventStamp.h
+ * \brief ISR safe event timestamping with DS1302 RTC wall-clock time
+ * \details
+ *      Source:         https://github.com/Erriez/ErriezDS1302
+ *      Documentation:  https://erriez.github.io/ErriezDS1302
+ */
+
+#ifndef ERRIEZ_DS1302_EVENT_STAMP_H_
+#define ERRIEZ_DS1302_EVENT_STAMP_H_
+
+#include "ErriezDS1302.h"
+
+#if defined(ARDUINO) && DS1302_FEATURE_EPOCH
+
+//! Number of entries in the event queue, power of two up to 128
+#ifndef DS1302_EVENT_QUEUE_SIZE
+#define DS1302_EVENT_QUEUE_SIZE     16
+#endif
+
+#if (DS1302_EVENT_QUEUE_SIZE & (DS1302_EVENT_QUEUE_SIZE - 1)) || (DS1302_EVENT_QUEUE_SIZE > 128)
+#error "DS1302_EVENT_QUEUE_SIZE must be a power of two up to 128"
+#endif
+
+//! Event queue index mask
+#define DS1302_EVENT_QUEUE_MASK     (DS1302_EVENT_QUEUE_SIZE - 1)
+
+//! Maximum time in ms sync() waits for a seconds change
+#define DS1302_EVENT_SYNC_TIMEOUT   1100
+
+//! DS1302 RTC event timestamp class
+class ErriezDS1302EventStamp
+{
+public:
+    // Constructor
+    ErriezDS1302EventStamp(ErriezDS1302 *rtc);
+
+    // Time anchor, call from the main loop
+    bool sync();
+    bool update();
+    bool isSynchronized();
+
+    /*!
+     * \brief Timestamp an event.
+     * \details
+     *      Interrupt safe: reads micros() and pushes it into the single producer / single
+     *      consumer queue. Call from one interrupt handler only. The event is dropped when the
+     *      queue is full. Always inlined, so it runs from the memory of the calling interrupt
+     *      handler, for example IRAM on ESP8266/ESP32.
+     */
+    inline __attribute__((always_inline)) void stamp()
+    {
+        uint32_t us = micros();
+        uint8_t head = _head;
+        uint8_t next = (head + 1) & DS1302_EVENT_QUEUE_MASK;
+
+        if (next == __atomic_load_n(&_tail, __ATOMIC_ACQUIRE)) {
+            _dropped++;
+            return;
+        }
+        _queue[head] = us;
+        __atomic_store_n(&_head, next, __ATOMIC_RELEASE);
+    }
+
+    // Drain queue, call from the main loop
+    bool pop(time_t *t, uint16_t *ms);
+    uint8_t available();
+    uint16_t getDropped();
+
+    // Conversion of micros() to wall-clock time
+    bool now(time_t *t, uint16_t *ms);
+    bool convert(uint32_t us, time_t *t, uint16_t *ms);
+
+private:
+    ErriezDS1302 *_rtc;                                 //!< RTC
+
+    volatile uint32_t _queue[DS1302_EVENT_QUEUE_SIZE];  //!< micros() per event
+    volatile uint8_t _head;                             //!< Write index, owned by stamp()
+    volatile uint8_t _tail;                             //!< Read index, owned by pop()
+    volatile uint16_t _dropped;                         //!< Events dropped on a full queue
+
+    time_t _anchorEpoch;                                //!< Epoch at the anchor
+    uint32_t _anchorMicros;                             //!< micros() at the anchor
+    bool _anchorValid;                                  //!< Anchor is valid
+    uint8_t _lastSeconds;                               //!< Last seconds register value
+    bool _lastValid;                                    //!< _lastSeconds is valid
+};
+
+#endif // ARDUINO && DS1302_FEATURE_EPOCH
+
+#endif // ERRIEZ_DS1302_EVENT_STAMP_H_
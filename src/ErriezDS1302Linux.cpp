@@ -0,0 +1,326 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \file ErriezDS1302Linux.cpp
+ * \brief DS1302 RTC library Linux GPIO character device backend
+ * \details
+ *      Source:         https://github.com/Erriez/ErriezDS1302
+ *      Documentation:  https://erriez.github.io/ErriezDS1302
+ *
+ *      CLK, IO and CE are requested as one multi-line request on /dev/gpiochipN (GPIO v2 uAPI).
+ *      The uAPI sets one state of the lines per ioctl, so every CLK edge costs an ioctl. All other
+ *      pin changes are merged into those ioctls:
+ *        - Data changes are written with the falling CLK edge of the previous bit.
+ *        - IO direction changes are written with the next CLK edge as one
+ *          GPIO_V2_LINE_SET_CONFIG ioctl. IO is line 0, so gpiolib releases IO before CLK falls.
+ *        - CE changes carry pending data and direction changes, and are kept one ioctl apart
+ *          from CLK edges (tCC, tCCH).
+ *      A written bit costs two ioctls, a read bit three: two CLK edges and one IO sample.
+ */
+
+#include "ErriezDS1302.h"
+
+#ifdef DS1302_LINUX_GPIO
+
+#include <fcntl.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#include <linux/gpio.h>
+
+//! All lines in the GPIO line request
+#define DS1302_LINE_ALL     (DS1302_LINE_CLK | DS1302_LINE_IO | DS1302_LINE_CE)
+
+/*!
+ * \brief Constructor DS1302 RTC on a Linux GPIO character device.
+ * \param chipPath
+ *      GPIO character device, for example "/dev/gpiochip0".
+ * \param clkLine
+ *      Clock line offset.
+ * \param ioLine
+ *      I/O line offset.
+ * \param ceLine
+ *      Chip enable line offset.
+ */
+ErriezDS1302::ErriezDS1302(const char *chipPath, uint8_t clkLine, uint8_t ioLine, uint8_t ceLine) :
+        _clkPin(clkLine), _ioPin(ioLine), _cePin(ceLine), _chipPath(chipPath), _lineFd(-1),
+        _lineValues(0), _lineActual(0), _ioInput(false), _ioInputActual(false), _lineError(false),
+        _syscalls(0), _transferStart(0), _transferSyscalls(0)
+{
+#ifdef DS1302_TRACE
+    clearTrace();
+#endif
+}
+
+/*!
+ * \brief Destructor releases the GPIO lines.
+ */
+ErriezDS1302::~ErriezDS1302()
+{
+    end();
+}
+
+/*!
+ * \brief Release GPIO lines.
+ */
+void ErriezDS1302::end()
+{
+    if (_lineFd >= 0) {
+        close(_lineFd);
+        _lineFd = -1;
+    }
+}
+
+/*!
+ * \brief Get total number of GPIO ioctls since begin().
+ * \return
+ *      Number of ioctls.
+ */
+uint32_t ErriezDS1302::getSyscallCount()
+{
+    return _syscalls;
+}
+
+/*!
+ * \brief Get number of GPIO ioctls of the last transfer (CE high to CE low).
+ * \return
+ *      Number of ioctls.
+ */
+uint32_t ErriezDS1302::getTransferSyscallCount()
+{
+    return _transferSyscalls;
+}
+
+// -------------------------------------------------------------------------------------------------
+// Private functions
+// -------------------------------------------------------------------------------------------------
+/*!
+ * \brief Request CLK, IO and CE lines as outputs driven low.
+ * \retval true
+ *      Success.
+ * \retval false
+ *      Opening the GPIO chip or requesting the lines failed.
+ */
+bool ErriezDS1302::gpioOpen()
+{
+    struct gpio_v2_line_request req;
+    int chipFd;
+
+    end();
+    _syscalls = 0;
+
+    chipFd = open(_chipPath, O_RDWR | O_CLOEXEC);
+    if (chipFd < 0) {
+        return false;
+    }
+
+    memset(&req, 0, sizeof(req));
+    req.offsets[0] = _ioPin;
+    req.offsets[1] = _clkPin;
+    req.offsets[2] = _cePin;
+    req.num_lines = 3;
+    strncpy(req.consumer, "ErriezDS1302", sizeof(req.consumer) - 1);
+    req.config.flags = GPIO_V2_LINE_FLAG_OUTPUT;
+    req.config.num_attrs = 1;
+    req.config.attrs[0].attr.id = GPIO_V2_LINE_ATTR_ID_OUTPUT_VALUES;
+    req.config.attrs[0].attr.values = 0;
+    req.config.attrs[0].mask = DS1302_LINE_ALL;
+
+    _syscalls++;
+    if (ioctl(chipFd, GPIO_V2_GET_LINE_IOCTL, &req) < 0) {
+        close(chipFd);
+        return false;
+    }
+    close(chipFd);
+
+    _lineFd = req.fd;
+    _lineValues = 0;
+    _lineActual = 0;
+    _ioInput = false;
+    _ioInputActual = false;
+    _lineError = false;
+
+    return true;
+}
+
+/*!
+ * \brief Write line directions and staged output values with one ioctl.
+ * \retval true
+ *      Success.
+ * \retval false
+ *      Line configuration failed.
+ */
+bool ErriezDS1302::gpioConfigure()
+{
+    struct gpio_v2_line_config config;
+    uint8_t outputs = DS1302_LINE_ALL;
+
+    memset(&config, 0, sizeof(config));
+    config.flags = GPIO_V2_LINE_FLAG_OUTPUT;
+    if (_ioInput) {
+        outputs &= ~DS1302_LINE_IO;
+        config.attrs[config.num_attrs].attr.id = GPIO_V2_LINE_ATTR_ID_FLAGS;
+        config.attrs[config.num_attrs].attr.flags = GPIO_V2_LINE_FLAG_INPUT;
+        config.attrs[config.num_attrs].mask = DS1302_LINE_IO;
+        config.num_attrs++;
+    }
+    config.attrs[config.num_attrs].attr.id = GPIO_V2_LINE_ATTR_ID_OUTPUT_VALUES;
+    config.attrs[config.num_attrs].attr.values = _lineValues & outputs;
+    config.attrs[config.num_attrs].mask = outputs;
+    config.num_attrs++;
+
+    _syscalls++;
+    if (ioctl(_lineFd, GPIO_V2_LINE_SET_CONFIG_IOCTL, &config) < 0) {
+        _lineError = true;
+        return false;
+    }
+
+    // Staged output values are written by the configuration
+    _ioInputActual = _ioInput;
+    _lineActual = (_lineActual & ~outputs) | (_lineValues & outputs);
+
+    return true;
+}
+
+/*!
+ * \brief Stage line level without writing it to the kernel.
+ * \param mask
+ *      Line mask DS1302_LINE_CLK, DS1302_LINE_IO or DS1302_LINE_CE.
+ * \param high
+ *      true: high, false: low.
+ */
+void ErriezDS1302::gpioStage(uint8_t mask, bool high)
+{
+    if (high) {
+        _lineValues |= mask;
+    } else {
+        _lineValues &= ~mask;
+    }
+}
+
+/*!
+ * \brief Write staged direction and output values with a single multi-line ioctl.
+ * \details
+ *      A failed ioctl is reported by transferEnd().
+ */
+void ErriezDS1302::gpioFlush()
+{
+    struct gpio_v2_line_values values;
+    uint8_t changed;
+
+    if (_ioInput != _ioInputActual) {
+        gpioConfigure();
+        return;
+    }
+
+    changed = _lineValues ^ _lineActual;
+    if (_ioInput) {
+        changed &= ~DS1302_LINE_IO;
+    }
+    if (!changed) {
+        return;
+    }
+
+    values.bits = _lineValues;
+    values.mask = changed;
+
+    _syscalls++;
+    if (ioctl(_lineFd, GPIO_V2_LINE_SET_VALUES_IOCTL, &values) < 0) {
+        _lineError = true;
+        return;
+    }
+
+    _lineActual = (_lineActual & ~changed) | (_lineValues & changed);
+}
+
+/*!
+ * \brief Rising CLK edge after writing the staged falling edge and data.
+ * \details
+ *      When CLK is already high, a staged IO turnaround is kept for the next falling edge.
+ */
+void ErriezDS1302::gpioClkHigh()
+{
+    if (_lineValues & _lineActual & DS1302_LINE_CLK) {
+        return;
+    }
+
+    gpioFlush();
+    gpioStage(DS1302_LINE_CLK, true);
+    gpioFlush();
+}
+
+/*!
+ * \brief Change CE with staged data and direction changes.
+ * \param high
+ *      true: high, false: low.
+ */
+void ErriezDS1302::gpioCe(bool high)
+{
+    // A staged CLK edge is written first: CLK low before CE high (tCC), CLK to CE hold (tCCH)
+    if ((_lineValues ^ _lineActual) & DS1302_LINE_CLK) {
+        gpioFlush();
+        if (_lineError) {
+            // Failed CLK edge: change CE only, the transfer is reported as failed
+            _lineValues = (_lineValues & ~DS1302_LINE_CLK) | (_lineActual & DS1302_LINE_CLK);
+        }
+    }
+
+    gpioStage(DS1302_LINE_CE, high);
+    gpioFlush();
+}
+
+/*!
+ * \brief Stage IO line direction.
+ * \param input
+ *      true: input, false: output.
+ */
+void ErriezDS1302::gpioDirection(bool input)
+{
+    _ioInput = input;
+}
+
+/*!
+ * \brief Read IO line after writing staged output values.
+ * \return
+ *      IO line level.
+ */
+bool ErriezDS1302::gpioRead()
+{
+    struct gpio_v2_line_values values;
+
+    gpioFlush();
+
+    values.bits = 0;
+    values.mask = DS1302_LINE_IO;
+
+    _syscalls++;
+    if (ioctl(_lineFd, GPIO_V2_LINE_GET_VALUES_IOCTL, &values) < 0) {
+        _lineError = true;
+        return false;
+    }
+
+    return (values.bits & DS1302_LINE_IO) ? true : false;
+}
+
+#endif // DS1302_LINUX_GPIO
@@ -0,0 +1,231 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \file ErriezDS1302RAMMirror.cpp
+ * \brief DS1302 RTC RAM mirror with dirty tracking
+ * \details
+ *      Source:         https://github.com/Erriez/ErriezDS1302
+ *      Documentation:  https://erriez.github.io/ErriezDS1302
+ */
+
+#include "ErriezDS1302RAMMirror.h"
+
+#if DS1302_FEATURE_RAM
+
+/*!
+ * \brief Constructor RAM mirror.
+ * \details
+ *      The mirror is cleared and not dirty. Call load() to read the RTC RAM.
+ * \param rtc
+ *      Initialized RTC object.
+ */
+ErriezDS1302RAMMirror::ErriezDS1302RAMMirror(ErriezDS1302 *rtc) :
+        _rtc(rtc), _dirty(0), _loaded(false)
+{
+    memset(_ram, 0, sizeof(_ram));
+}
+
+/*!
+ * \brief Read all RTC RAM registers into the mirror with one burst.
+ * \details
+ *      Local changes which are not flushed are discarded.
+ */
+void ErriezDS1302RAMMirror::load()
+{
+    _rtc->readBufferRAM(_ram, sizeof(_ram));
+    _dirty = 0;
+    _loaded = true;
+}
+
+/*!
+ * \brief Write dirty bytes to RTC RAM.
+ * \details
+ *      A RAM burst always starts at address 0. The flush writes a burst of the first
+ *      addresses followed by single byte writes for the remaining dirty addresses. The burst
+ *      length is chosen for the least number of bit-clocks, which may be no burst at all.
+ *
+ *      A burst also writes the clean bytes before the last dirty byte of the burst. Without a
+ *      load(), these bytes are not known, so only single byte writes of the dirty bytes are used
+ *      and RTC RAM bytes which are not written by the application are kept.
+ * \return
+ *      Number of bit-clocks written.
+ */
+uint16_t ErriezDS1302RAMMirror::flush()
+{
+    uint16_t clocks;
+    uint16_t bestClocks;
+    uint8_t burstLen = 0;
+    uint8_t numSingle = 0;
+    uint8_t addr;
+
+    if (!_dirty) {
+        return 0;
+    }
+
+    // Count dirty bytes for single byte writes only
+    for (addr = 0; addr < DS1302_NUM_RAM_REGS; addr++) {
+        if (_dirty & (1UL << addr)) {
+            numSingle++;
+        }
+    }
+    bestClocks = numSingle * DS1302_RAM_SINGLE_CLOCKS;
+
+    // Try all burst lengths ending at a dirty byte, only when the clean bytes are loaded
+    for (addr = 0; _loaded && (addr < DS1302_NUM_RAM_REGS); addr++) {
+        if (_dirty & (1UL << addr)) {
+            numSingle--;
+            clocks = DS1302_RAM_BURST_CMD_CLOCKS + ((addr + 1) * DS1302_RAM_BURST_CLOCKS) +
+                     (numSingle * DS1302_RAM_SINGLE_CLOCKS);
+            if (clocks < bestClocks) {
+                bestClocks = clocks;
+                burstLen = addr + 1;
+            }
+        }
+    }
+
+    // Write burst
+    if (burstLen) {
+        _rtc->writeBufferRAM(_ram, burstLen);
+    }
+
+    // Write remaining dirty bytes
+    for (addr = burstLen; addr < DS1302_NUM_RAM_REGS; addr++) {
+        if (_dirty & (1UL << addr)) {
+            _rtc->writeByteRAM(addr, _ram[addr]);
+        }
+    }
+
+    _dirty = 0;
+
+    return bestClocks;
+}
+
+/*!
+ * \brief Read byte from mirror.
+ * \param addr
+ *      RAM address 0..0x1E
+ * \return
+ *      RAM byte 0..0xFF
+ */
+uint8_t ErriezDS1302RAMMirror::read(uint8_t addr)
+{
+    if (addr >= DS1302_NUM_RAM_REGS) {
+        return 0;
+    }
+
+    return _ram[addr];
+}
+
+/*!
+ * \brief Write byte to mirror.
+ * \details
+ *      After load(), the byte is marked dirty only when the value changes.
+ * \param addr
+ *      RAM address 0..0x1E
+ * \param value
+ *      RAM byte 0..0xFF
+ */
+void ErriezDS1302RAMMirror::write(uint8_t addr, uint8_t value)
+{
+    if (addr >= DS1302_NUM_RAM_REGS) {
+        return;
+    }
+
+    if (!_loaded || (_ram[addr] != value)) {
+        _ram[addr] = value;
+        _dirty |= (1UL << addr);
+    }
+}
+
+/*!
+ * \brief Read buffer from mirror.
+ * \param addr
+ *      Start RAM address 0..0x1E
+ * \param buf
+ *      Data buffer
+ * \param len
+ *      Buffer length, limited to the end of RAM
+ */
+void ErriezDS1302RAMMirror::readBuffer(uint8_t addr, void *buf, uint8_t len)
+{
+    for (uint8_t i = 0; (i < len) && (addr < DS1302_NUM_RAM_REGS); i++) {
+        ((uint8_t *)buf)[i] = _ram[addr++];
+    }
+}
+
+/*!
+ * \brief Write buffer to mirror.
+ * \details
+ *      Only changed bytes are marked dirty, so a complete state struct can be written after
+ *      changing a single field.
+ * \param addr
+ *      Start RAM address 0..0x1E
+ * \param buf
+ *      Data buffer
+ * \param len
+ *      Buffer length, limited to the end of RAM
+ */
+void ErriezDS1302RAMMirror::writeBuffer(uint8_t addr, const void *buf, uint8_t len)
+{
+    for (uint8_t i = 0; (i < len) && (addr < DS1302_NUM_RAM_REGS); i++) {
+        write(addr++, ((const uint8_t *)buf)[i]);
+    }
+}
+
+/*!
+ * \brief Check for bytes which are not written to RTC RAM.
+ * \retval true
+ *      One or more bytes are dirty.
+ * \retval false
+ *      Mirror is equal to RTC RAM.
+ */
+bool ErriezDS1302RAMMirror::isDirty()
+{
+    return _dirty ? true : false;
+}
+
+/*!
+ * \brief Force writing a byte at the next flush().
+ * \param addr
+ *      RAM address 0..0x1E
+ */
+void ErriezDS1302RAMMirror::markDirty(uint8_t addr)
+{
+    if (addr < DS1302_NUM_RAM_REGS) {
+        _dirty |= (1UL << addr);
+    }
+}
+
+/*!
+ * \brief Get dirty bitmap.
+ * \return
+ *      Bit n set when RAM address n is dirty.
+ */
+uint32_t ErriezDS1302RAMMirror::getDirty()
+{
+    return _dirty;
+}
+
+#endif // DS1302_FEATURE_RAM
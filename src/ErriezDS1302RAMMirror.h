@@ -0,0 +1,78 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \file ErriezDS1302RAMMirror.h
+ * \brief DS1302 RTC RAM mirror with dirty tracking
+ * \details
+ *      Source:         https://github.com/Erriez/ErriezDS1302
+ *      Documentation:  https://erriez.github.io/ErriezDS1302
+ */
+
+#ifndef ERRIEZ_DS1302_RAM_MIRROR_H_
+#define ERRIEZ_DS1302_RAM_MIRROR_H_
+
+#include "ErriezDS1302.h"
+
+#if DS1302_FEATURE_RAM
+
+//! Number of clocks for a single byte RAM write: command + data byte
+#define DS1302_RAM_SINGLE_CLOCKS    16
+//! Number of clocks for a burst command
+#define DS1302_RAM_BURST_CMD_CLOCKS 8
+//! Number of clocks per byte in burst mode
+#define DS1302_RAM_BURST_CLOCKS     8
+
+//! DS1302 RAM mirror class
+class ErriezDS1302RAMMirror
+{
+public:
+    // Constructor
+    ErriezDS1302RAMMirror(ErriezDS1302 *rtc);
+
+    // Transfer between mirror and RTC RAM
+    void load();
+    uint16_t flush();
+
+    // Access mirror
+    uint8_t read(uint8_t addr);
+    void write(uint8_t addr, uint8_t value);
+    void readBuffer(uint8_t addr, void *buf, uint8_t len);
+    void writeBuffer(uint8_t addr, const void *buf, uint8_t len);
+
+    // Dirty tracking
+    bool isDirty();
+    void markDirty(uint8_t addr);
+    uint32_t getDirty();
+
+private:
+    ErriezDS1302 *_rtc;                         //!< RTC
+    uint8_t _ram[DS1302_NUM_RAM_REGS];          //!< Local copy of RTC RAM
+    uint32_t _dirty;                            //!< Dirty bit per RAM address
+    bool _loaded;                               //!< Mirror read from RTC RAM by load()
+};
+
+#endif // DS1302_FEATURE_RAM
+
+#endif // ERRIEZ_DS1302_RAM_MIRROR_H_
@@ -0,0 +1,865 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \file ErriezDS1302Sim.cpp
+ * \brief DS1302 RTC cycle-level simulator and protocol timing verifier for host builds
+ * \details
+ *      Source:         https://github.com/Erriez/ErriezDS1302
+ *      Documentation:  https://erriez.github.io/ErriezDS1302
+ *
+ *      The library drives the simulator through the pin macros when compiled with
+ *      DS1302_SIMULATOR. Every pin operation advances a virtual clock by the duration configured
+ *      with setTiming(), so the edges are timestamped as they would be on the modeled target.
+ *      Each edge is checked against the datasheet AC characteristics and the 3-wire state
+ *      machine of the chip responds to the commands.
+ */
+
+#ifndef ARDUINO
+
+#include <string.h>
+#include <time.h>
+#include "ErriezDS1302Sim.h"
+
+//! Datasheet AC characteristics in ns at VCC = 2.0V and VCC = 5.0V
+static const uint32_t phaseLimits[2][DS1302_SIM_NUM_PHASES] = {
+    //  tDC, tCDH, tCDD,  tCL,  tCH,  tCC, tCCH, tCWH
+    {   200,  280,  800, 1000, 1000, 4000,  240, 4000 },    // 2.0V
+    {    50,   70,  200,  250,  250, 1000,   60, 1000 },    // 5.0V
+};
+
+//! Phase names for the report
+static const char *phaseNames[DS1302_SIM_NUM_PHASES] = {
+    "tDC  data to CLK setup",
+    "tCDH CLK to data hold",
+    "tCDD CLK to data delay",
+    "tCL  CLK low time",
+    "tCH  CLK high time",
+    "tCC  CE to CLK setup",
+    "tCCH CLK to CE hold",
+    "tCWH CE inactive time",
+};
+
+//! BCD to decimal
+static uint8_t bcdToDec(uint8_t bcd)
+{
+    return (uint8_t)(10 * ((bcd & 0xF0) >> 4) + (bcd & 0x0F));
+}
+
+//! Decimal to BCD
+static uint8_t decToBcd(uint8_t dec)
+{
+    return (uint8_t)(((dec / 10) << 4) | (dec % 10));
+}
+
+/*!
+ * \brief Get monotonic time
+ * \return
+ *      Time in ns.
+ */
+static uint64_t monotonicNs()
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+/*!
+ * \brief Constructor simulator.
+ * \details
+ *      The chip is powered on with the oscillator halted and write protect set. The default
+ *      timing model is an ideal target with zero pin access time at 5.0V supply voltage.
+ */
+ErriezDS1302Sim::ErriezDS1302Sim() : _realTime(false), _vcd(NULL)
+{
+    setTiming(0, 0, 0, 0);
+    setSupplyVoltage(false);
+    powerOn();
+}
+
+/*!
+ * \brief Destructor closes the VCD trace.
+ */
+ErriezDS1302Sim::~ErriezDS1302Sim()
+{
+    closeVcd();
+}
+
+/*!
+ * \brief Set target timing model.
+ * \param pinWriteNs
+ *      Duration of a pin write, for example digitalWrite() or a port register write.
+ * \param pinReadNs
+ *      Duration of a pin read.
+ * \param pinModeNs
+ *      Duration of a pin direction change.
+ * \param pinDelayNs
+ *      Duration of DS1302_PIN_DELAY().
+ */
+void ErriezDS1302Sim::setTiming(uint32_t pinWriteNs, uint32_t pinReadNs, uint32_t pinModeNs,
+                                uint32_t pinDelayNs)
+{
+    _pinWriteNs = pinWriteNs;
+    _pinReadNs = pinReadNs;
+    _pinModeNs = pinModeNs;
+    _pinDelayNs = pinDelayNs;
+}
+
+/*!
+ * \brief Select datasheet timing limits.
+ * \details
+ *      Statistics are reset.
+ * \param lowVoltage
+ *      true: VCC = 2.0V limits, false: VCC = 5.0V limits.
+ */
+void ErriezDS1302Sim::setSupplyVoltage(bool lowVoltage)
+{
+    for (uint8_t i = 0; i < DS1302_SIM_NUM_PHASES; i++) {
+        _phases[i].limit = phaseLimits[lowVoltage ? 0 : 1][i];
+    }
+    resetStats();
+}
+
+/*!
+ * \brief Get simulation time.
+ * \return
+ *      Time in ns since power on.
+ */
+uint64_t ErriezDS1302Sim::getTime()
+{
+    return _now;
+}
+
+/*!
+ * \brief Pace transfers in real time.
+ * \details
+ *      At the CE falling edge, the calling thread sleeps until the real time since the CE
+ *      rising edge matches the simulated duration of the transfer, so a transfer blocks the
+ *      calling thread as long as on the modeled target while other threads can run. Used to
+ *      test concurrent access from multiple threads.
+ * \param enable
+ *      true: Real time, false: As fast as possible (default).
+ */
+void ErriezDS1302Sim::setRealTime(bool enable)
+{
+    _realTime = enable;
+}
+
+/*!
+ * \brief Sleep until the real time since the CE rising edge matches the simulated time.
+ */
+void ErriezDS1302Sim::pace()
+{
+    uint64_t real = monotonicNs() - _realStart;
+    uint64_t sim = _now - _simStart;
+    struct timespec ts;
+
+    if (real < sim) {
+        ts.tv_sec = (sim - real) / 1000000000ULL;
+        ts.tv_nsec = (sim - real) % 1000000000ULL;
+        nanosleep(&ts, NULL);
+    }
+}
+
+/*!
+ * \brief Write pin.
+ * \param pin
+ *      DS1302_SIM_CLK, DS1302_SIM_IO or DS1302_SIM_CE.
+ * \param high
+ *      Pin level.
+ */
+void ErriezDS1302Sim::pinWrite(uint8_t pin, bool high)
+{
+    _now += _pinWriteNs;
+
+    if (pin == DS1302_SIM_CE) {
+        if (_realTime && (high != _ce)) {
+            if (high) {
+                _realStart = monotonicNs();
+                _simStart = _now;
+            } else {
+                pace();
+            }
+        }
+        if (high != _ce) {
+            ceChange(high);
+        }
+    } else if (pin == DS1302_SIM_CLK) {
+        if (high != _clk) {
+            _clk = high;
+            if (high) {
+                clkRise();
+            } else {
+                clkFall();
+            }
+        }
+    } else if (pin == DS1302_SIM_IO) {
+        if ((high != _ioMaster) && !_ioInput) {
+            // Data may only change after the hold time of the previous rising edge
+            if (_ce && !_firstClk && (_clkRise > _ioChange)) {
+                check(DS1302_SIM_TCDH, _clkRise);
+            }
+            _ioChange = _now;
+        }
+        _ioMaster = high;
+    }
+
+    vcdDump();
+}
+
+/*!
+ * \brief Change pin direction.
+ * \details
+ *      Only the IO pin direction is modeled.
+ * \param pin
+ *      DS1302_SIM_CLK, DS1302_SIM_IO or DS1302_SIM_CE.
+ * \param input
+ *      true: input, false: output.
+ */
+void ErriezDS1302Sim::pinMode(uint8_t pin, bool input)
+{
+    _now += _pinModeNs;
+
+    if ((pin == DS1302_SIM_IO) && (input != _ioInput)) {
+        _ioInput = input;
+        if (!input) {
+            _ioChange = _now;
+            if (_slaveDrive) {
+                _contentions++;
+            }
+        }
+    }
+
+    vcdDump();
+}
+
+/*!
+ * \brief Read IO pin.
+ * \details
+ *      Data driven by the chip is valid tCDD after the falling CLK edge. A sample before that
+ *      returns the previous bit and is reported as tCDD violation.
+ * \return
+ *      IO level.
+ */
+bool ErriezDS1302Sim::pinRead()
+{
+    _now += _pinReadNs;
+
+    if (!_ioInput) {
+        return _ioMaster;
+    }
+    if (!_slaveDrive) {
+        return false;
+    }
+
+    check(DS1302_SIM_TCDD, _clkFall);
+    if ((_now - _clkFall) >= _phases[DS1302_SIM_TCDD].limit) {
+        _ioSlave = _ioSlaveNext;
+    }
+
+    return _ioSlave;
+}
+
+/*!
+ * \brief DS1302_PIN_DELAY().
+ */
+void ErriezDS1302Sim::pinDelay()
+{
+    _now += _pinDelayNs;
+}
+
+/*!
+ * \brief Clear timing statistics, violation log and contention counter.
+ */
+void ErriezDS1302Sim::resetStats()
+{
+    for (uint8_t i = 0; i < DS1302_SIM_NUM_PHASES; i++) {
+        _phases[i].minimum = UINT32_MAX;
+        _phases[i].samples = 0;
+        _phases[i].violations = 0;
+    }
+    _numLog = 0;
+    _contentions = 0;
+}
+
+/*!
+ * \brief Get total number of timing violations.
+ * \return
+ *      Number of violations of all phases.
+ */
+uint32_t ErriezDS1302Sim::getViolations()
+{
+    uint32_t violations = 0;
+
+    for (uint8_t i = 0; i < DS1302_SIM_NUM_PHASES; i++) {
+        violations += _phases[i].violations;
+    }
+
+    return violations;
+}
+
+/*!
+ * \brief Get timing slack of a phase.
+ * \param phase
+ *      DS1302_SIM_TDC..DS1302_SIM_TCWH.
+ * \return
+ *      Smallest measured time minus datasheet limit in ns. Negative is a violation. INT32_MAX
+ *      when the phase was not measured.
+ */
+int32_t ErriezDS1302Sim::getSlack(uint8_t phase)
+{
+    if ((phase >= DS1302_SIM_NUM_PHASES) || !_phases[phase].samples) {
+        return INT32_MAX;
+    }
+
+    return (int32_t)((int64_t)_phases[phase].minimum - _phases[phase].limit);
+}
+
+/*!
+ * \brief Get timing statistics of a phase.
+ * \param phase
+ *      DS1302_SIM_TDC..DS1302_SIM_TCWH.
+ * \return
+ *      Phase statistics, or NULL when phase is invalid.
+ */
+const DS1302SimPhase *ErriezDS1302Sim::getPhase(uint8_t phase)
+{
+    if (phase >= DS1302_SIM_NUM_PHASES) {
+        return NULL;
+    }
+
+    return &_phases[phase];
+}
+
+/*!
+ * \brief Get first timing violations.
+ * \param log
+ *      Pointer to first violation.
+ * \return
+ *      Number of logged violations, maximum DS1302_SIM_NUM_VIOLATIONS.
+ */
+uint8_t ErriezDS1302Sim::getViolationLog(const DS1302SimViolation **log)
+{
+    *log = _log;
+
+    return _numLog;
+}
+
+/*!
+ * \brief Get number of IO bus contentions.
+ * \return
+ *      Number of times the library and the chip drove IO at the same time.
+ */
+uint32_t ErriezDS1302Sim::getContentions()
+{
+    return _contentions;
+}
+
+/*!
+ * \brief Print timing report.
+ * \param out
+ *      Output stream.
+ */
+void ErriezDS1302Sim::printReport(FILE *out)
+{
+    const DS1302SimPhase *p;
+
+    fprintf(out, "%-24s %8s %8s %8s %8s %10s\n",
+            "Phase", "Limit", "Min", "Slack", "Samples", "Violations");
+    for (uint8_t i = 0; i < DS1302_SIM_NUM_PHASES; i++) {
+        p = &_phases[i];
+        if (!p->samples) {
+            fprintf(out, "%-24s %8u %8s %8s %8u %10u\n", phaseNames[i], p->limit, "-", "-", 0, 0);
+        } else {
+            fprintf(out, "%-24s %8u %8u %8d %8u %10u\n", phaseNames[i], p->limit, p->minimum,
+                    getSlack(i), p->samples, p->violations);
+        }
+    }
+    fprintf(out, "IO contentions: %u\n", _contentions);
+
+    for (uint8_t i = 0; i < _numLog; i++) {
+        fprintf(out, "Violation at %llu ns: %s %u ns < %u ns\n", (unsigned long long)_log[i].time,
+                phaseNames[_log[i].phase], _log[i].measured, _phases[_log[i].phase].limit);
+    }
+}
+
+/*!
+ * \brief Start VCD trace of CE, SCLK, IO and IO driver.
+ * \param path
+ *      Output file.
+ * \retval true
+ *      Success.
+ * \retval false
+ *      File could not be created.
+ */
+bool ErriezDS1302Sim::openVcd(const char *path)
+{
+    closeVcd();
+
+    _vcd = fopen(path, "w");
+    if (!_vcd) {
+        return false;
+    }
+
+    fprintf(_vcd, "$timescale 1ns $end\n"
+                  "$scope module ds1302 $end\n"
+                  "$var wire 1 ! CE $end\n"
+                  "$var wire 1 \" SCLK $end\n"
+                  "$var wire 1 # IO $end\n"
+                  "$var wire 1 $ IO_CHIP_DRIVES $end\n"
+                  "$upscope $end\n"
+                  "$enddefinitions $end\n");
+    // Dump initial values
+    memset(_vcdLast, 0, sizeof(_vcdLast));
+    vcdDump();
+
+    return true;
+}
+
+/*!
+ * \brief Stop VCD trace.
+ */
+void ErriezDS1302Sim::closeVcd()
+{
+    if (_vcd) {
+        fclose(_vcd);
+        _vcd = NULL;
+    }
+}
+
+/*!
+ * \brief Read clock register.
+ * \param reg
+ *      Register 0x00..0x08.
+ * \return
+ *      Register value, or 0 when reg is invalid.
+ */
+uint8_t ErriezDS1302Sim::getRegister(uint8_t reg)
+{
+    return (reg < sizeof(_regs)) ? _regs[reg] : 0;
+}
+
+/*!
+ * \brief Write clock register, ignoring write protect.
+ * \param reg
+ *      Register 0x00..0x08.
+ * \param value
+ *      Register value.
+ */
+void ErriezDS1302Sim::setRegister(uint8_t reg, uint8_t value)
+{
+    if (reg < sizeof(_regs)) {
+        _regs[reg] = value;
+    }
+}
+
+/*!
+ * \brief Read RAM.
+ * \param addr
+ *      RAM address 0..0x1E.
+ * \return
+ *      RAM byte, or 0 when addr is invalid.
+ */
+uint8_t ErriezDS1302Sim::getRAM(uint8_t addr)
+{
+    return (addr < sizeof(_ram)) ? _ram[addr] : 0;
+}
+
+/*!
+ * \brief Write RAM, ignoring write protect.
+ * \param addr
+ *      RAM address 0..0x1E.
+ * \param value
+ *      RAM byte.
+ */
+void ErriezDS1302Sim::setRAM(uint8_t addr, uint8_t value)
+{
+    if (addr < sizeof(_ram)) {
+        _ram[addr] = value;
+    }
+}
+
+/*!
+ * \brief Power on the chip.
+ * \details
+ *      Oscillator halted, 2000-01-01 00:00:00 Sunday, write protect set, trickle charger
+ *      disabled, RAM cleared and all pins low. Statistics are reset.
+ */
+void ErriezDS1302Sim::powerOn()
+{
+    static const uint8_t regs[9] = { 0x80, 0x00, 0x00, 0x01, 0x01, 0x01, 0x00, 0x80, 0x5C };
+
+    memcpy(_regs, regs, sizeof(_regs));
+    memset(_ram, 0, sizeof(_ram));
+
+    _now = 0;
+    _ce = false;
+    _clk = false;
+    _ioMaster = false;
+    _ioInput = false;
+    _ioSlave = false;
+    _ioSlaveNext = false;
+    _slaveDrive = false;
+    _ceRise = 0;
+    _ceFall = 0;
+    _clkRise = 0;
+    _clkFall = 0;
+    _ioChange = 0;
+    _firstClk = true;
+    _ceFallValid = false;
+    _cmd = 0;
+    _bits = 0;
+
+    resetStats();
+}
+
+/*!
+ * \brief Advance the clock registers when the oscillator is running.
+ * \details
+ *      Only 24-hour mode is simulated.
+ * \param seconds
+ *      Number of seconds.
+ */
+void ErriezDS1302Sim::advance(uint32_t seconds)
+{
+    static const uint8_t daysInMonth[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+    uint8_t sec, min, hour, mday, mon, wday, year, mdays;
+
+    if (_regs[0] & 0x80) {
+        // Clock halted
+        return;
+    }
+
+    sec = bcdToDec(_regs[0] & 0x7F);
+    min = bcdToDec(_regs[1] & 0x7F);
+    hour = bcdToDec(_regs[2] & 0x3F);
+    mday = bcdToDec(_regs[3] & 0x3F);
+    mon = bcdToDec(_regs[4] & 0x1F);
+    wday = bcdToDec(_regs[5] & 0x07);
+    year = bcdToDec(_regs[6]);
+
+    while (seconds--) {
+        if (++sec < 60) {
+            continue;
+        }
+        sec = 0;
+        if (++min < 60) {
+            continue;
+        }
+        min = 0;
+        if (++hour < 24) {
+            continue;
+        }
+        hour = 0;
+        wday = (wday % 7) + 1;
+        mdays = daysInMonth[(mon - 1) % 12] + (((mon == 2) && ((year % 4) == 0)) ? 1 : 0);
+        if (++mday <= mdays) {
+            continue;
+        }
+        mday = 1;
+        if (++mon <= 12) {
+            continue;
+        }
+        mon = 1;
+        year = (year + 1) % 100;
+    }
+
+    _regs[0] = decToBcd(sec);
+    _regs[1] = decToBcd(min);
+    _regs[2] = decToBcd(hour);
+    _regs[3] = decToBcd(mday);
+    _regs[4] = decToBcd(mon);
+    _regs[5] = decToBcd(wday);
+    _regs[6] = decToBcd(year);
+}
+
+// -------------------------------------------------------------------------------------------------
+// Private functions
+// -------------------------------------------------------------------------------------------------
+/*!
+ * \brief Check time since an edge against the datasheet limit.
+ * \param phase
+ *      DS1302_SIM_TDC..DS1302_SIM_TCWH.
+ * \param from
+ *      Timestamp of the edge which starts the phase.
+ */
+void ErriezDS1302Sim::check(uint8_t phase, uint64_t from)
+{
+    DS1302SimPhase *p = &_phases[phase];
+    uint64_t elapsed = _now - from;
+    uint32_t measured = (elapsed > UINT32_MAX) ? UINT32_MAX : (uint32_t)elapsed;
+
+    p->samples++;
+    if (measured < p->minimum) {
+        p->minimum = measured;
+    }
+    if (measured < p->limit) {
+        p->violations++;
+        if (_numLog < DS1302_SIM_NUM_VIOLATIONS) {
+            _log[_numLog].time = _now;
+            _log[_numLog].measured = measured;
+            _log[_numLog].phase = phase;
+            _numLog++;
+        }
+    }
+}
+
+/*!
+ * \brief CLK rising edge: shift in command and write data.
+ */
+void ErriezDS1302Sim::clkRise()
+{
+    uint8_t bit;
+
+    if (!_ce) {
+        return;
+    }
+
+    if (_firstClk) {
+        check(DS1302_SIM_TCC, _ceRise);
+        _firstClk = false;
+    } else {
+        check(DS1302_SIM_TCL, _clkFall);
+    }
+    _clkRise = _now;
+
+    if ((_bits >= 8) && (_cmd & 0x01)) {
+        // Read data is shifted out on falling edges
+        return;
+    }
+
+    if (!_ioInput) {
+        check(DS1302_SIM_TDC, _ioChange);
+    }
+    bit = (!_ioInput && _ioMaster) ? 1 : 0;
+
+    if (_bits < 8) {
+        // Address/command byte, LSB first
+        _cmd |= (bit << _bits);
+    } else {
+        // Write data, LSB first
+        _shift |= (bit << ((_bits - 8) % 8));
+        if (((_bits - 8) % 8) == 7) {
+            commitByte(_shift);
+            _shift = 0;
+            _index++;
+        }
+    }
+    if (_bits < 0xFFFF) {
+        _bits++;
+    }
+}
+
+/*!
+ * \brief CLK falling edge: shift out read data.
+ */
+void ErriezDS1302Sim::clkFall()
+{
+    uint16_t n;
+
+    if (!_ce) {
+        return;
+    }
+
+    if (!_firstClk) {
+        check(DS1302_SIM_TCH, _clkRise);
+    }
+
+    // Previous output bit is settled after tCDD
+    if (_slaveDrive && ((_now - _clkFall) >= _phases[DS1302_SIM_TCDD].limit)) {
+        _ioSlave = _ioSlaveNext;
+    }
+    _clkFall = _now;
+
+    if ((_bits < 8) || !(_cmd & 0x80) || !(_cmd & 0x01)) {
+        return;
+    }
+
+    // Output next data bit, LSB first
+    n = _bits - 8;
+    if ((n % 8) == 0) {
+        _outByte = readData(n / 8);
+    }
+    _ioSlaveNext = (_outByte >> (n % 8)) & 0x01;
+    if (!_slaveDrive) {
+        _ioSlave = _ioSlaveNext;
+        _slaveDrive = true;
+        if (!_ioInput) {
+            _contentions++;
+        }
+    }
+    if (_bits < 0xFFFF) {
+        _bits++;
+    }
+}
+
+/*!
+ * \brief CE edge: start or end a session.
+ * \param high
+ *      CE level.
+ */
+void ErriezDS1302Sim::ceChange(bool high)
+{
+    _ce = high;
+
+    if (high) {
+        if (_ceFallValid) {
+            check(DS1302_SIM_TCWH, _ceFall);
+        }
+        if (_clk) {
+            // CLK must be low when CE is driven high
+            check(DS1302_SIM_TCC, _now);
+        }
+        _ceRise = _now;
+        _firstClk = true;
+        _cmd = 0;
+        _shift = 0;
+        _bits = 0;
+        _index = 0;
+    } else {
+        if (!_firstClk) {
+            check(DS1302_SIM_TCCH, (_clkRise > _clkFall) ? _clkRise : _clkFall);
+        }
+        _ceFall = _now;
+        _ceFallValid = true;
+        _slaveDrive = false;
+    }
+}
+
+/*!
+ * \brief Store a received data byte.
+ * \param value
+ *      Data byte.
+ */
+void ErriezDS1302Sim::commitByte(uint8_t value)
+{
+    uint8_t addr = (_cmd >> 1) & 0x1F;
+    bool wp = (_regs[7] & 0x80) ? true : false;
+
+    if (!(_cmd & 0x80)) {
+        // Bit 7 must be set, otherwise the command is ignored
+        return;
+    }
+
+    if (_cmd & 0x40) {
+        // RAM
+        if (wp) {
+            return;
+        }
+        if (addr == 31) {
+            if (_index < sizeof(_ram)) {
+                _ram[_index] = value;
+            }
+        } else if ((addr < sizeof(_ram)) && (_index == 0)) {
+            _ram[addr] = value;
+        }
+    } else {
+        // Clock
+        if (addr == 31) {
+            // Clock burst is transferred after all 8 registers are written
+            if (_index < sizeof(_burst)) {
+                _burst[_index] = value;
+            }
+            if ((_index == 7) && !wp) {
+                memcpy(_regs, _burst, sizeof(_burst));
+                _regs[7] &= 0x80;
+            }
+        } else if (_index == 0) {
+            if (addr == 7) {
+                _regs[7] = value & 0x80;
+            } else if ((addr < sizeof(_regs)) && !wp) {
+                _regs[addr] = value;
+            }
+        }
+    }
+}
+
+/*!
+ * \brief Get data byte for a read command.
+ * \param index
+ *      Byte index in the session.
+ * \return
+ *      Data byte.
+ */
+uint8_t ErriezDS1302Sim::readData(uint8_t index)
+{
+    uint8_t addr = (_cmd >> 1) & 0x1F;
+
+    if (_cmd & 0x40) {
+        if (addr == 31) {
+            return _ram[index % sizeof(_ram)];
+        }
+        return (addr < sizeof(_ram)) ? _ram[addr] : 0;
+    }
+
+    if (addr == 31) {
+        return _regs[index % 8];
+    }
+
+    return (addr < sizeof(_regs)) ? _regs[addr] : 0;
+}
+
+/*!
+ * \brief Write changed signals to the VCD trace.
+ */
+void ErriezDS1302Sim::vcdDump()
+{
+    char values[4];
+    bool first = true;
+
+    if (!_vcd) {
+        return;
+    }
+
+    values[0] = _ce ? '1' : '0';
+    values[1] = _clk ? '1' : '0';
+    if (_slaveDrive && !_ioInput) {
+        values[2] = 'x';
+    } else if (_slaveDrive) {
+        if ((_now - _clkFall) >= _phases[DS1302_SIM_TCDD].limit) {
+            values[2] = _ioSlaveNext ? '1' : '0';
+        } else {
+            values[2] = _ioSlave ? '1' : '0';
+        }
+    } else if (!_ioInput) {
+        values[2] = _ioMaster ? '1' : '0';
+    } else {
+        values[2] = 'z';
+    }
+    values[3] = _slaveDrive ? '1' : '0';
+
+    for (uint8_t i = 0; i < 4; i++) {
+        if (values[i] != _vcdLast[i]) {
+            if (first) {
+                fprintf(_vcd, "#%llu\n", (unsigned long long)_now);
+                first = false;
+            }
+            fprintf(_vcd, "%c%c\n", values[i], "!\"#$"[i]);
+            _vcdLast[i] = values[i];
+        }
+    }
+}
+
+#endif // ARDUINO
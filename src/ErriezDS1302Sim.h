@@ -0,0 +1,173 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \file ErriezDS1302Sim.h
+ * \brief DS1302 RTC cycle-level simulator and protocol timing verifier for host builds
+ * \details
+ *      Source:         https://github.com/Erriez/ErriezDS1302
+ *      Documentation:  https://erriez.github.io/ErriezDS1302
+ */
+
+#ifndef ERRIEZ_DS1302_SIM_H_
+#define ERRIEZ_DS1302_SIM_H_
+
+#include <stdint.h>
+#include <stdio.h>
+
+//! Simulator pin numbers
+#define DS1302_SIM_CLK          0       //!< CLK pin
+#define DS1302_SIM_IO           1       //!< IO pin
+#define DS1302_SIM_CE           2       //!< CE pin
+
+//! Timing phases checked against the datasheet
+#define DS1302_SIM_TDC          0       //!< Data to CLK setup
+#define DS1302_SIM_TCDH         1       //!< CLK to data hold
+#define DS1302_SIM_TCDD         2       //!< CLK to data delay (read sample after falling edge)
+#define DS1302_SIM_TCL          3       //!< CLK low time
+#define DS1302_SIM_TCH          4       //!< CLK high time
+#define DS1302_SIM_TCC          5       //!< CE to CLK setup
+#define DS1302_SIM_TCCH         6       //!< CLK to CE hold
+#define DS1302_SIM_TCWH         7       //!< CE inactive time
+#define DS1302_SIM_NUM_PHASES   8       //!< Number of timing phases
+
+//! Number of logged timing violations
+#define DS1302_SIM_NUM_VIOLATIONS   16
+
+//! Timing violation
+struct DS1302SimViolation {
+    uint64_t time;          //!< Simulation time in ns
+    uint32_t measured;      //!< Measured time in ns
+    uint8_t phase;          //!< DS1302_SIM_TDC..DS1302_SIM_TCWH
+};
+
+//! Timing statistics per phase
+struct DS1302SimPhase {
+    uint32_t limit;         //!< Datasheet minimum in ns
+    uint32_t minimum;       //!< Smallest measured time in ns
+    uint32_t samples;       //!< Number of measurements
+    uint32_t violations;    //!< Number of measurements below the limit
+};
+
+//! DS1302 RTC simulator class
+class ErriezDS1302Sim
+{
+public:
+    // Constructor
+    ErriezDS1302Sim();
+    ~ErriezDS1302Sim();
+
+    // Target timing model
+    void setTiming(uint32_t pinWriteNs, uint32_t pinReadNs, uint32_t pinModeNs, uint32_t pinDelayNs);
+    void setSupplyVoltage(bool lowVoltage);
+    void setRealTime(bool enable);
+    uint64_t getTime();
+
+    // Pin interface called by the library
+    void pinWrite(uint8_t pin, bool high);
+    void pinMode(uint8_t pin, bool input);
+    bool pinRead();
+    void pinDelay();
+
+    // Timing verification
+    void resetStats();
+    uint32_t getViolations();
+    int32_t getSlack(uint8_t phase);
+    const DS1302SimPhase *getPhase(uint8_t phase);
+    uint8_t getViolationLog(const DS1302SimViolation **log);
+    uint32_t getContentions();
+    void printReport(FILE *out);
+
+    // VCD trace export
+    bool openVcd(const char *path);
+    void closeVcd();
+
+    // Chip model
+    uint8_t getRegister(uint8_t reg);
+    void setRegister(uint8_t reg, uint8_t value);
+    uint8_t getRAM(uint8_t addr);
+    void setRAM(uint8_t addr, uint8_t value);
+    void powerOn();
+    void advance(uint32_t seconds);
+
+private:
+    // Target timing model
+    uint32_t _pinWriteNs;                               //!< Pin write duration
+    uint32_t _pinReadNs;                                //!< Pin read duration
+    uint32_t _pinModeNs;                                //!< Pin mode change duration
+    uint32_t _pinDelayNs;                               //!< DS1302_PIN_DELAY() duration
+    uint64_t _now;                                      //!< Simulation time in ns
+    bool _realTime;                                     //!< Pace transfers in real time
+    uint64_t _realStart;                                //!< Monotonic time at CE rising edge
+    uint64_t _simStart;                                 //!< Simulation time at CE rising edge
+
+    // Pin state
+    bool _ce;                                           //!< CE level
+    bool _clk;                                          //!< CLK level
+    bool _ioMaster;                                     //!< IO level driven by the library
+    bool _ioInput;                                      //!< Library IO pin is input
+    bool _ioSlave;                                      //!< IO level driven by the chip
+    bool _ioSlaveNext;                                  //!< Next IO level driven by the chip
+    bool _slaveDrive;                                   //!< Chip drives IO
+
+    // Edge timestamps
+    uint64_t _ceRise;                                   //!< Last CE rising edge
+    uint64_t _ceFall;                                   //!< Last CE falling edge
+    uint64_t _clkRise;                                  //!< Last CLK rising edge
+    uint64_t _clkFall;                                  //!< Last CLK falling edge
+    uint64_t _ioChange;                                 //!< Last IO change by the library
+    bool _firstClk;                                     //!< No CLK rising edge since CE high
+    bool _ceFallValid;                                  //!< _ceFall is valid
+
+    // Verification
+    DS1302SimPhase _phases[DS1302_SIM_NUM_PHASES];              //!< Timing statistics
+    DS1302SimViolation _log[DS1302_SIM_NUM_VIOLATIONS];         //!< First violations
+    uint8_t _numLog;                                            //!< Number of logged violations
+    uint32_t _contentions;                                      //!< IO driven by both sides
+
+    // VCD trace
+    FILE *_vcd;                                         //!< VCD output file
+    char _vcdLast[4];                                   //!< Last signal levels written to VCD
+
+    // Chip model
+    uint8_t _regs[9];                                   //!< Clock, WP and TC registers
+    uint8_t _ram[31];                                   //!< RAM
+    uint8_t _burst[8];                                  //!< Clock burst write buffer
+    uint8_t _cmd;                                       //!< Address/command byte
+    uint8_t _shift;                                     //!< Data shift register
+    uint16_t _bits;                                     //!< Number of bits shifted in the session
+    uint8_t _index;                                     //!< Byte index in the session
+    uint8_t _outByte;                                   //!< Byte shifted out
+
+    void pace();
+    void check(uint8_t phase, uint64_t from);
+    void clkRise();
+    void clkFall();
+    void ceChange(bool high);
+    void commitByte(uint8_t value);
+    uint8_t readData(uint8_t index);
+    void vcdDump();
+};
+
+#endif // ERRIEZ_DS1302_SIM_H_
@@ -0,0 +1,381 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \file ErriezDS1302TimeLog.cpp
+ * \brief Delta compressed timestamp encoder and seekable decoder for data logging
+ * \details
+ *      Source:         https://github.com/Erriez/ErriezDS1302
+ *      Documentation:  https://erriez.github.io/ErriezDS1302
+ */
+
+#include "ErriezDS1302TimeLog.h"
+
+/*!
+ * \brief CRC-8, polynomial 0x07
+ * \param buf
+ *      Data.
+ * \param len
+ *      Data length.
+ * \return
+ *      CRC.
+ */
+static uint8_t crc8(const uint8_t *buf, uint8_t len)
+{
+    uint8_t crc = 0;
+
+    while (len--) {
+        crc ^= *buf++;
+        for (uint8_t i = 0; i < 8; i++) {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+        }
+    }
+
+    return crc;
+}
+
+/*!
+ * \brief Constructor timestamp encoder.
+ * \param msResolution
+ *      true:  Millisecond timestamps.\n
+ *      false: Second timestamps.
+ * \param refInterval
+ *      Number of records between reference timestamps, 1 or higher. A decoder can start or
+ *      resynchronize at every reference.
+ */
+ErriezDS1302TimeLogEncoder::ErriezDS1302TimeLogEncoder(bool msResolution, uint16_t refInterval) :
+        _msResolution(msResolution), _refInterval(refInterval ? refInterval : 1), _count(0),
+        _last(0)
+{
+}
+
+/*!
+ * \brief Emit a reference timestamp at the next encode().
+ * \details
+ *      Call when starting a new file or log block.
+ */
+void ErriezDS1302TimeLogEncoder::reset()
+{
+    _count = 0;
+}
+
+/*!
+ * \brief Encode timestamp.
+ * \details
+ *      Timestamps are usually obtained from ErriezDS1302::getEpoch() or
+ *      ErriezDS1302EventStamp::now().
+ * \param t
+ *      Unix epoch in seconds.
+ * \param ms
+ *      Milliseconds 0..999, ignored at second resolution.
+ * \param buf
+ *      Output buffer of at least DS1302_TIMELOG_MAX_RECORD bytes.
+ * \return
+ *      Number of bytes written to buf.
+ */
+uint8_t ErriezDS1302TimeLogEncoder::encode(time_t t, uint16_t ms, uint8_t *buf)
+{
+    int64_t value = _msResolution ? ((int64_t)t * 1000 + ms) : (int64_t)t;
+    int64_t delta = value - _last;
+    uint32_t zigzag;
+    uint8_t len = 0;
+
+    _last = value;
+
+    if ((_count == 0) || (delta > DS1302_TIMELOG_MAX_DELTA) || (delta < -DS1302_TIMELOG_MAX_DELTA)) {
+        // Reference timestamp
+        _count = _refInterval - 1;
+
+        buf[0] = 0x00;
+        buf[1] = DS1302_TIMELOG_MAGIC;
+        buf[2] = _msResolution ? DS1302_TIMELOG_FLAG_MS : 0;
+        for (uint8_t i = 0; i < 8; i++) {
+            buf[3 + i] = (uint8_t)((uint64_t)value >> (i * 8));
+        }
+        buf[11] = crc8(&buf[1], 10);
+
+        return DS1302_TIMELOG_REF_SIZE;
+    }
+    _count--;
+
+    // Zig-zag, +1 reserves 0x00 for references
+    zigzag = (((uint32_t)delta << 1) ^ (uint32_t)((int32_t)delta >> 31)) + 1;
+
+    // LEB128 varint: only the first byte of value 0 is 0x00
+    while (zigzag >= 0x80) {
+        buf[len++] = (uint8_t)(zigzag | 0x80);
+        zigzag >>= 7;
+    }
+    buf[len++] = (uint8_t)zigzag;
+
+    return len;
+}
+
+/*!
+ * \brief Constructor timestamp decoder.
+ * \param buf
+ *      Encoded stream, for example a memory mapped log file.
+ * \param len
+ *      Stream length in bytes.
+ */
+ErriezDS1302TimeLogDecoder::ErriezDS1302TimeLogDecoder(const uint8_t *buf, size_t len) :
+        _buf(buf), _len(len)
+{
+    rewind();
+}
+
+/*!
+ * \brief Restart decoding at the start of the stream.
+ */
+void ErriezDS1302TimeLogDecoder::rewind()
+{
+    _pos = 0;
+    _last = 0;
+    _msResolution = false;
+    _synced = false;
+    _errors = 0;
+}
+
+/*!
+ * \brief Get read position.
+ * \return
+ *      Byte offset of the next record.
+ */
+size_t ErriezDS1302TimeLogDecoder::tell()
+{
+    return _pos;
+}
+
+/*!
+ * \brief Get number of corrupt records skipped.
+ * \return
+ *      Number of resynchronizations.
+ */
+uint32_t ErriezDS1302TimeLogDecoder::getErrors()
+{
+    return _errors;
+}
+
+/*!
+ * \brief Decode next timestamp.
+ * \details
+ *      Corrupt data is skipped up to the next reference.
+ * \param t
+ *      Unix epoch in seconds.
+ * \param ms
+ *      Milliseconds, 0 at second resolution.
+ * \retval true
+ *      Timestamp decoded.
+ * \retval false
+ *      End of stream.
+ */
+bool ErriezDS1302TimeLogDecoder::next(time_t *t, uint16_t *ms)
+{
+    bool found = false;
+
+    while (!found && (_pos < _len)) {
+        if (_buf[_pos] == 0x00) {
+            if (parseReference(_pos, &_last, &_msResolution)) {
+                _pos += DS1302_TIMELOG_REF_SIZE;
+                _synced = true;
+                found = true;
+            }
+        } else if (_synced) {
+            found = decodeDelta();
+        }
+
+        if (!found) {
+            // Corrupt or not synchronized: skip to next reference
+            _pos = findReference(_pos + 1, _len);
+            _synced = false;
+            _errors++;
+        }
+    }
+
+    if (!found) {
+        return false;
+    }
+
+    if (_msResolution) {
+        *t = (time_t)(_last / 1000);
+        *ms = (uint16_t)(_last % 1000);
+    } else {
+        *t = (time_t)_last;
+        *ms = 0;
+    }
+
+    return true;
+}
+
+/*!
+ * \brief Seek to the first timestamp at or after a given time.
+ * \details
+ *      Binary search over the reference timestamps, then decodes forward from the closest
+ *      preceding reference. Requires a stream with ascending timestamps.
+ * \param t
+ *      Unix epoch in seconds.
+ * \param ms
+ *      Milliseconds 0..999.
+ * \retval true
+ *      The next call to next() returns the timestamp found.
+ * \retval false
+ *      No timestamp at or after t.
+ */
+bool ErriezDS1302TimeLogDecoder::seek(time_t t, uint16_t ms)
+{
+    int64_t target = (int64_t)t * 1000 + ms;
+    int64_t value;
+    bool msResolution;
+    size_t lo;
+    size_t hi;
+    size_t mid;
+    size_t ref;
+    time_t rt;
+    uint16_t rms;
+
+    lo = findReference(0, _len);
+    if (lo >= _len) {
+        return false;
+    }
+
+    // Find last reference at or before target
+    hi = _len;
+    while ((hi - lo) > 1) {
+        mid = lo + (hi - lo) / 2;
+        ref = findReference(mid, hi);
+        if (ref >= hi) {
+            hi = mid;
+            continue;
+        }
+        parseReference(ref, &value, &msResolution);
+        if ((msResolution ? value : (value * 1000)) <= target) {
+            lo = ref;
+        } else {
+            hi = ref;
+        }
+    }
+
+    // Decode forward and stop before the first timestamp at or after target
+    _pos = lo;
+    _synced = false;
+    for (;;) {
+        size_t pos = _pos;
+        int64_t last = _last;
+        bool lastMs = _msResolution;
+        bool synced = _synced;
+
+        if (!next(&rt, &rms)) {
+            return false;
+        }
+        if (((int64_t)rt * 1000 + rms) >= target) {
+            _pos = pos;
+            _last = last;
+            _msResolution = lastMs;
+            _synced = synced;
+            return true;
+        }
+    }
+}
+
+/*!
+ * \brief Decode delta at the read position.
+ * \retval true
+ *      Delta applied to the last timestamp.
+ * \retval false
+ *      Corrupt or truncated delta.
+ */
+bool ErriezDS1302TimeLogDecoder::decodeDelta()
+{
+    uint32_t zigzag = 0;
+    uint8_t shift = 0;
+
+    // Varint of at most 5 bytes, 0x00 is never part of a delta
+    for (size_t pos = _pos; (pos < _len) && (shift < 35) && _buf[pos]; pos++, shift += 7) {
+        zigzag |= (uint32_t)(_buf[pos] & 0x7F) << shift;
+        if (!(_buf[pos] & 0x80)) {
+            zigzag--;
+            _last += (int32_t)((zigzag >> 1) ^ (0 - (zigzag & 1)));
+            _pos = pos + 1;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/*!
+ * \brief Parse and check reference record.
+ * \param pos
+ *      Position of the 0x00 escape byte.
+ * \param value
+ *      Timestamp in units.
+ * \param msResolution
+ *      Millisecond resolution flag.
+ * \retval true
+ *      Valid reference.
+ * \retval false
+ *      No reference, truncated or CRC error.
+ */
+bool ErriezDS1302TimeLogDecoder::parseReference(size_t pos, int64_t *value, bool *msResolution)
+{
+    const uint8_t *ref = &_buf[pos];
+    uint64_t v = 0;
+
+    if (((_len - pos) < DS1302_TIMELOG_REF_SIZE) || (ref[0] != 0x00) ||
+        (ref[1] != DS1302_TIMELOG_MAGIC) || (ref[2] & ~DS1302_TIMELOG_FLAG_MS) ||
+        (crc8(&ref[1], 10) != ref[11])) {
+        return false;
+    }
+
+    for (uint8_t i = 0; i < 8; i++) {
+        v |= (uint64_t)ref[3 + i] << (i * 8);
+    }
+    *value = (int64_t)v;
+    *msResolution = ref[2] & DS1302_TIMELOG_FLAG_MS;
+
+    return true;
+}
+
+/*!
+ * \brief Find next valid reference record.
+ * \param pos
+ *      Start position.
+ * \param end
+ *      End position, the reference must start before end.
+ * \return
+ *      Position of the reference, or end when not found.
+ */
+size_t ErriezDS1302TimeLogDecoder::findReference(size_t pos, size_t end)
+{
+    int64_t value;
+    bool msResolution;
+
+    for (; pos < end; pos++) {
+        if ((_buf[pos] == 0x00) && parseReference(pos, &value, &msResolution)) {
+            return pos;
+        }
+    }
+
+    return end;
+}
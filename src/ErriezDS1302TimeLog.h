@@ -0,0 +1,109 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \file ErriezDS1302TimeLog.h
+ * \brief Delta compressed timestamp encoder and seekable decoder for data logging
+ * \details
+ *      Source:         https://github.com/Erriez/ErriezDS1302
+ *      Documentation:  https://erriez.github.io/ErriezDS1302
+ *
+ *      Stream format:
+ *        Reference: 0x00, 'T', flags, 8-byte little endian timestamp, CRC-8 (12 bytes)
+ *        Delta:     LEB128 varint of zig-zag(delta) + 1 (1..5 bytes)
+ *
+ *      The timestamp unit is seconds, or milliseconds when flag bit 0 is set. A delta never
+ *      contains a 0x00 byte, so a decoder finds the next reference by scanning for 0x00 'T' and
+ *      checking the CRC.
+ */
+
+#ifndef ERRIEZ_DS1302_TIME_LOG_H_
+#define ERRIEZ_DS1302_TIME_LOG_H_
+
+#include "ErriezDS1302.h"
+
+//! Default number of records between reference timestamps
+#ifndef DS1302_TIMELOG_REF_INTERVAL
+#define DS1302_TIMELOG_REF_INTERVAL     64
+#endif
+
+//! Maximum record size in bytes
+#define DS1302_TIMELOG_MAX_RECORD       12
+
+//! Reference record size in bytes
+#define DS1302_TIMELOG_REF_SIZE         12
+//! Reference record magic after the 0x00 escape byte
+#define DS1302_TIMELOG_MAGIC            'T'
+//! Reference flags: millisecond resolution
+#define DS1302_TIMELOG_FLAG_MS          0x01
+
+//! Maximum delta in timestamp units, larger steps emit a reference
+#define DS1302_TIMELOG_MAX_DELTA        0x3FFFFFFFL
+
+//! Timestamp encoder class
+class ErriezDS1302TimeLogEncoder
+{
+public:
+    // Constructor
+    ErriezDS1302TimeLogEncoder(bool msResolution=false,
+                               uint16_t refInterval=DS1302_TIMELOG_REF_INTERVAL);
+
+    void reset();
+    uint8_t encode(time_t t, uint16_t ms, uint8_t *buf);
+
+private:
+    bool _msResolution;     //!< Millisecond resolution
+    uint16_t _refInterval;  //!< Number of records between references
+    uint16_t _count;        //!< Records until next reference
+    int64_t _last;          //!< Last timestamp in units
+};
+
+//! Seekable timestamp decoder class
+class ErriezDS1302TimeLogDecoder
+{
+public:
+    // Constructor
+    ErriezDS1302TimeLogDecoder(const uint8_t *buf, size_t len);
+
+    bool next(time_t *t, uint16_t *ms);
+    bool seek(time_t t, uint16_t ms);
+    void rewind();
+    size_t tell();
+    uint32_t getErrors();
+
+private:
+    const uint8_t *_buf;    //!< Encoded stream
+    size_t _len;            //!< Stream length
+    size_t _pos;            //!< Read position
+    int64_t _last;          //!< Last timestamp in units
+    bool _msResolution;     //!< Millisecond resolution of the last reference
+    bool _synced;           //!< A reference has been decoded
+    uint32_t _errors;       //!< Number of corrupt records skipped
+
+    bool decodeDelta();
+    bool parseReference(size_t pos, int64_t *value, bool *msResolution);
+    size_t findReference(size_t pos, size_t end);
+};
+
+#endif // ERRIEZ_DS1302_TIME_LOG_H_
@@ -0,0 +1,408 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \file ErriezDS1302TimePage.h
+ * \brief Shared memory time page published by a DS1302 RTC daemon on Linux
+ * \details
+ *      Source:         https://github.com/Erriez/ErriezDS1302
+ *      Documentation:  https://erriez.github.io/ErriezDS1302
+ *
+ *      One daemon owns the DS1302 bus and publishes the RTC time in a POSIX shared memory page.
+ *      The page holds the Unix epoch of the current RTC second and the CLOCK_MONOTONIC time at
+ *      which that second started. Clients read the page with a sequence lock and add the
+ *      monotonic time elapsed since the anchor, so a read takes no lock and no system call
+ *      (clock_gettime() is served by the vDSO).
+ *
+ *      Header-only without dependencies on the library, clients only include this file.
+ *      Link with -lrt on glibc versions before 2.17.
+ */
+
+#ifndef ERRIEZ_DS1302_TIME_PAGE_H_
+#define ERRIEZ_DS1302_TIME_PAGE_H_
+
+#ifndef ARDUINO
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+//! Default shared memory object name, /dev/shm/ds1302-time
+#define DS1302_TIME_PAGE_NAME           "/ds1302-time"
+
+//! Page identification "DS13"
+#define DS1302_TIME_PAGE_MAGIC          0x33315344UL
+//! Page layout version
+#define DS1302_TIME_PAGE_VERSION        1
+
+//! Page age after which a running clock is reported stale
+#ifndef DS1302_TIME_PAGE_STALE_MS
+#define DS1302_TIME_PAGE_STALE_MS       3000
+#endif
+
+//! Read attempts before giving up on a page left locked by a crashed daemon
+#ifndef DS1302_TIME_PAGE_MAX_SPIN
+#define DS1302_TIME_PAGE_MAX_SPIN       1000000UL
+#endif
+
+//! RTC read and date/time valid
+#define DS1302_TIME_PAGE_VALID          0x01
+//! Clock halt (CH) bit set, time does not advance
+#define DS1302_TIME_PAGE_HALTED         0x02
+//! Anchor taken at an observed seconds transition
+#define DS1302_TIME_PAGE_SYNCED         0x08
+//! Set by the client: no update by the daemon within DS1302_TIME_PAGE_STALE_MS
+#define DS1302_TIME_PAGE_STALE          0x80
+
+//! Shared memory page layout
+struct DS1302TimePageData {
+    uint32_t magic;             //!< DS1302_TIME_PAGE_MAGIC, written last on creation
+    uint32_t version;           //!< DS1302_TIME_PAGE_VERSION
+    uint32_t seq;               //!< Sequence lock, odd during an update
+    uint32_t flags;             //!< DS1302_TIME_PAGE_VALID..DS1302_TIME_PAGE_SYNCED
+    int64_t epoch;              //!< Unix epoch UTC of the RTC second
+    int64_t anchorNs;           //!< CLOCK_MONOTONIC at the start of the RTC second
+    uint32_t uncertaintyNs;     //!< Maximum anchor error
+    uint32_t updates;           //!< Number of updates by the daemon
+};
+
+//! Consistent copy of the time page
+struct DS1302TimeSnapshot {
+    int64_t epoch;              //!< Unix epoch UTC of the RTC second
+    int64_t anchorNs;           //!< CLOCK_MONOTONIC at the start of the RTC second
+    uint32_t uncertaintyNs;     //!< Maximum anchor error
+    uint32_t updates;           //!< Number of updates by the daemon
+    uint32_t flags;             //!< DS1302_TIME_PAGE_VALID..DS1302_TIME_PAGE_STALE
+};
+
+//! DS1302 RTC shared memory time page, daemon and client side
+class ErriezDS1302TimePage
+{
+public:
+    /*!
+     * \brief Constructor
+     */
+    ErriezDS1302TimePage() : _page(NULL), _fd(-1)
+    {
+    }
+
+    /*!
+     * \brief Destructor
+     */
+    ~ErriezDS1302TimePage()
+    {
+        close();
+    }
+
+    /*!
+     * \brief Create or reopen the page for publishing, daemon side
+     * \details
+     *      An exclusive lock on the shared memory object refuses a second daemon. The sequence
+     *      count of an existing page is kept, so clients survive a daemon restart.
+     * \param name
+     *      Shared memory object name.
+     * \retval true
+     *      Success.
+     * \retval false
+     *      Create failed or page owned by another daemon.
+     */
+    bool create(const char *name=DS1302_TIME_PAGE_NAME)
+    {
+        uint32_t seq;
+
+        close();
+
+        _fd = shm_open(name, O_CREAT | O_RDWR, 0644);
+        if (_fd < 0) {
+            return false;
+        }
+        if ((flock(_fd, LOCK_EX | LOCK_NB) < 0) || (ftruncate(_fd, pageSize()) < 0)) {
+            close();
+            return false;
+        }
+
+        _page = (DS1302TimePageData *)mmap(NULL, pageSize(), PROT_READ | PROT_WRITE,
+                                           MAP_SHARED, _fd, 0);
+        if (_page == MAP_FAILED) {
+            _page = NULL;
+            close();
+            return false;
+        }
+
+        if ((_page->magic != DS1302_TIME_PAGE_MAGIC) ||
+            (_page->version != DS1302_TIME_PAGE_VERSION)) {
+            // New page: initialize all fields with an odd sequence count, so that a reader which
+            // passed the magic check of an old page retries, and leave the count even
+            __atomic_store_n(&_page->magic, 0, __ATOMIC_RELAXED);
+            seq = __atomic_load_n(&_page->seq, __ATOMIC_RELAXED) | 1;
+            __atomic_store_n(&_page->seq, seq, __ATOMIC_RELAXED);
+            __atomic_thread_fence(__ATOMIC_RELEASE);
+            _page->version = DS1302_TIME_PAGE_VERSION;
+            _page->flags = 0;
+            _page->epoch = 0;
+            _page->anchorNs = 0;
+            _page->uncertaintyNs = 0;
+            _page->updates = 0;
+            __atomic_store_n(&_page->seq, seq + 1, __ATOMIC_RELEASE);
+            __atomic_store_n(&_page->magic, DS1302_TIME_PAGE_MAGIC, __ATOMIC_RELEASE);
+        } else {
+            // Daemon restart: finish an update interrupted by a crash of the previous daemon
+            // and mark the RTC state unknown until the first update
+            if (__atomic_load_n(&_page->seq, __ATOMIC_RELAXED) & 1) {
+                __atomic_add_fetch(&_page->seq, 1, __ATOMIC_RELEASE);
+            }
+            publish(_page->epoch, _page->anchorNs, _page->uncertaintyNs, 0);
+        }
+
+        return true;
+    }
+
+    /*!
+     * \brief Publish RTC time, daemon side
+     * \param epoch
+     *      Unix epoch UTC of the RTC second.
+     * \param anchorNs
+     *      CLOCK_MONOTONIC in ns at the start of the RTC second.
+     * \param uncertaintyNs
+     *      Maximum anchor error in ns.
+     * \param flags
+     *      DS1302_TIME_PAGE_VALID..DS1302_TIME_PAGE_SYNCED.
+     */
+    void publish(int64_t epoch, int64_t anchorNs, uint32_t uncertaintyNs, uint32_t flags)
+    {
+        volatile DS1302TimePageData *page = _page;
+        uint32_t seq;
+
+        if (page == NULL) {
+            return;
+        }
+
+        // Odd sequence count before the data changes
+        seq = __atomic_load_n(&_page->seq, __ATOMIC_RELAXED);
+        __atomic_store_n(&_page->seq, seq + 1, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+
+        page->flags = flags;
+        page->epoch = epoch;
+        page->anchorNs = anchorNs;
+        page->uncertaintyNs = uncertaintyNs;
+        page->updates = page->updates + 1;
+
+        // Even sequence count after the data changed
+        __atomic_store_n(&_page->seq, seq + 2, __ATOMIC_RELEASE);
+    }
+
+    /*!
+     * \brief Open the page read-only, client side
+     * \param name
+     *      Shared memory object name.
+     * \retval true
+     *      Success.
+     * \retval false
+     *      No daemon has created the page.
+     */
+    bool open(const char *name=DS1302_TIME_PAGE_NAME)
+    {
+        struct stat st;
+
+        close();
+
+        _fd = shm_open(name, O_RDONLY, 0);
+        if (_fd < 0) {
+            return false;
+        }
+        if ((fstat(_fd, &st) < 0) || (st.st_size < (off_t)sizeof(DS1302TimePageData))) {
+            close();
+            return false;
+        }
+
+        _page = (DS1302TimePageData *)mmap(NULL, pageSize(), PROT_READ, MAP_SHARED, _fd, 0);
+        if (_page == MAP_FAILED) {
+            _page = NULL;
+            close();
+            return false;
+        }
+
+        // The mapping stays valid without the descriptor
+        ::close(_fd);
+        _fd = -1;
+
+        return true;
+    }
+
+    /*!
+     * \brief Unmap the page
+     * \details
+     *      The shared memory object is not removed, clients keep their mapping and report the
+     *      page stale when the daemon stops.
+     */
+    void close()
+    {
+        if (_page != NULL) {
+            munmap(_page, pageSize());
+            _page = NULL;
+        }
+        if (_fd >= 0) {
+            ::close(_fd);
+            _fd = -1;
+        }
+    }
+
+    /*!
+     * \brief Read a consistent copy of the page without locking
+     * \param snapshot
+     *      Copy of the page.
+     * \retval true
+     *      Success.
+     * \retval false
+     *      Page not open, not initialized or locked by a crashed daemon.
+     */
+    bool read(DS1302TimeSnapshot *snapshot) const
+    {
+        const volatile DS1302TimePageData *page = _page;
+        unsigned long spin = 0;
+        uint32_t seq;
+
+        if ((page == NULL) ||
+            (__atomic_load_n(&_page->magic, __ATOMIC_ACQUIRE) != DS1302_TIME_PAGE_MAGIC)) {
+            return false;
+        }
+
+        do {
+            // Wait while the daemon updates the page, which takes nanoseconds once a second
+            while ((seq = __atomic_load_n(&_page->seq, __ATOMIC_ACQUIRE)) & 1) {
+                if (++spin >= DS1302_TIME_PAGE_MAX_SPIN) {
+                    return false;
+                }
+            }
+
+            snapshot->flags = page->flags;
+            snapshot->epoch = page->epoch;
+            snapshot->anchorNs = page->anchorNs;
+            snapshot->uncertaintyNs = page->uncertaintyNs;
+            snapshot->updates = page->updates;
+
+            // Retry when the daemon updated the page during the copy
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        } while (__atomic_load_n(&_page->seq, __ATOMIC_RELAXED) != seq);
+
+        return true;
+    }
+
+    /*!
+     * \brief Get current RTC time with sub-second resolution
+     * \param ts
+     *      Unix epoch UTC with nanoseconds.
+     * \param flags
+     *      Optional DS1302_TIME_PAGE_VALID..DS1302_TIME_PAGE_STALE, NULL when not used.
+     * \retval true
+     *      Success.
+     * \retval false
+     *      No page, RTC not valid, clock halted or daemon not updating the page. ts contains
+     *      the last published time when the page could be read.
+     */
+    bool now(struct timespec *ts, uint32_t *flags=NULL) const
+    {
+        DS1302TimeSnapshot snapshot;
+        int64_t elapsedNs;
+
+        if (!read(&snapshot)) {
+            if (flags) {
+                *flags = 0;
+            }
+            return false;
+        }
+
+        ts->tv_sec = (time_t)snapshot.epoch;
+        ts->tv_nsec = 0;
+
+        elapsedNs = monotonicNs() - snapshot.anchorNs;
+        if (elapsedNs > ((int64_t)DS1302_TIME_PAGE_STALE_MS * 1000000LL)) {
+            snapshot.flags |= DS1302_TIME_PAGE_STALE;
+        } else if (!(snapshot.flags & DS1302_TIME_PAGE_HALTED) && (elapsedNs > 0)) {
+            ts->tv_sec += (time_t)(elapsedNs / 1000000000LL);
+            ts->tv_nsec = (long)(elapsedNs % 1000000000LL);
+        }
+
+        if (flags) {
+            *flags = snapshot.flags;
+        }
+
+        return (snapshot.flags & (DS1302_TIME_PAGE_VALID | DS1302_TIME_PAGE_HALTED |
+                                  DS1302_TIME_PAGE_STALE)) == DS1302_TIME_PAGE_VALID;
+    }
+
+    /*!
+     * \brief Get current RTC Unix epoch UTC
+     * \return
+     *      Unix epoch, 0 when now() fails.
+     */
+    time_t getEpoch() const
+    {
+        struct timespec ts;
+
+        if (!now(&ts)) {
+            return 0;
+        }
+
+        return ts.tv_sec;
+    }
+
+    /*!
+     * \brief Get CLOCK_MONOTONIC
+     * \return
+     *      Monotonic time in ns.
+     */
+    static int64_t monotonicNs()
+    {
+        struct timespec ts;
+
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+
+        return ((int64_t)ts.tv_sec * 1000000000LL) + ts.tv_nsec;
+    }
+
+private:
+    DS1302TimePageData *_page;  //!< Mapped page
+    int _fd;                    //!< Shared memory descriptor of the daemon
+
+    /*!
+     * \brief Size of the shared memory object
+     * \return
+     *      One memory page.
+     */
+    static size_t pageSize()
+    {
+        return (size_t)sysconf(_SC_PAGESIZE);
+    }
+};
+
+#endif // ARDUINO
+
+#endif // ERRIEZ_DS1302_TIME_PAGE_H_
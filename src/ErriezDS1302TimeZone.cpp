@@ -0,0 +1,583 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \file ErriezDS1302TimeZone.cpp
+ * \brief DS1302 RTC local time with POSIX TZ rules
+ * \details
+ *      Source:         https://github.com/Erriez/ErriezDS1302
+ *      Documentation:  https://erriez.github.io/ErriezDS1302
+ *
+ *      The RTC runs in UTC. The DST transitions of a POSIX TZ rule are calculated once by begin()
+ *      into a sorted table of UTC instants. A conversion is a binary search in this table, or a
+ *      compare when the time is within the cached offset interval of the previous call.
+ */
+
+#include "ErriezDS1302TimeZone.h"
+
+#if DS1302_FEATURE_TM
+
+//! Seconds per day
+#define SECONDS_PER_DAY     86400UL
+
+/*!
+ * \brief Constructor time zone.
+ * \details
+ *      The time zone is UTC until begin() is called.
+ * \param rtc
+ *      Initialized RTC object, running in UTC.
+ */
+ErriezDS1302TimeZone::ErriezDS1302TimeZone(ErriezDS1302 *rtc) :
+        _rtc(rtc), _stdOffset(0), _dstOffset(0), _hasDst(false), _numTransitions(0),
+        _firstIsDst(false), _cacheValid(false)
+{
+}
+
+/*!
+ * \brief Parse POSIX TZ rule and calculate DST transition table.
+ * \details
+ *      Format: std offset [dst [offset] [,start[/time],end[/time]]], for example
+ *      "CET-1CEST,M3.5.0,M10.5.0/3" or "<+10>-10". A DST name without rule uses the
+ *      default rule "M3.2.0,M11.1.0".
+ * \param tz
+ *      POSIX TZ rule string.
+ * \param firstYear
+ *      First year in the transition table. DS1302_TZ_NUM_YEARS years are calculated.
+ *      Conversions outside the table are calculated from the rule.
+ * \retval true
+ *      Success.
+ * \retval false
+ *      Invalid TZ string. The time zone is UTC.
+ */
+bool ErriezDS1302TimeZone::begin(const char *tz, uint16_t firstYear)
+{
+    const char *p = tz;
+    uint32_t start;
+    uint32_t end;
+
+    _stdOffset = 0;
+    _dstOffset = 0;
+    _hasDst = false;
+    _numTransitions = 0;
+    _cacheValid = false;
+
+    // Standard time name and offset west of UTC
+    p = parseName(p);
+    if (!p || !(p = parseTime(p, &_stdOffset))) {
+        _stdOffset = 0;
+        return false;
+    }
+    _stdOffset = -_stdOffset;
+    _dstOffset = _stdOffset;
+
+    if (*p == '\0') {
+        // No daylight saving time
+        return true;
+    }
+
+    // Daylight saving time name and optional offset, default one hour ahead
+    if (!(p = parseName(p))) {
+        _stdOffset = _dstOffset = 0;
+        return false;
+    }
+    _dstOffset = _stdOffset + 3600;
+    if ((*p != ',') && (*p != '\0')) {
+        if (!(p = parseTime(p, &_dstOffset))) {
+            _stdOffset = _dstOffset = 0;
+            return false;
+        }
+        _dstOffset = -_dstOffset;
+    }
+
+    // Transition rules
+    if (*p == '\0') {
+        p = ",M3.2.0,M11.1.0";
+    }
+    if ((*p != ',') || !(p = parseRule(p + 1, &_start)) ||
+        (*p != ',') || !(p = parseRule(p + 1, &_end)) || (*p != '\0')) {
+        _stdOffset = _dstOffset = 0;
+        return false;
+    }
+    _hasDst = true;
+
+    // Calculate sorted transition table
+    for (uint16_t year = firstYear; year < (firstYear + DS1302_TZ_NUM_YEARS); year++) {
+        yearTransitions(year, &start, &end);
+        if (year == firstYear) {
+            _firstIsDst = (start < end);
+        }
+        if (start < end) {
+            _transitions[_numTransitions++] = start;
+            _transitions[_numTransitions++] = end;
+        } else {
+            _transitions[_numTransitions++] = end;
+            _transitions[_numTransitions++] = start;
+        }
+    }
+
+    return true;
+}
+
+/*!
+ * \brief Convert UTC to local time.
+ * \param utc
+ *      Unix epoch UTC.
+ * \return
+ *      Local time in seconds since 1970-01-01 00:00:00 local time.
+ */
+time_t ErriezDS1302TimeZone::toLocal(time_t utc)
+{
+    return utc + getOffset(utc);
+}
+
+/*!
+ * \brief Convert local time to UTC.
+ * \details
+ *      A local time which exists twice at the end of DST is converted as standard time. A
+ *      local time in the gap at the start of DST is converted with the standard time offset.
+ * \param local
+ *      Local time in seconds since 1970-01-01 00:00:00 local time.
+ * \return
+ *      Unix epoch UTC.
+ */
+time_t ErriezDS1302TimeZone::toUtc(time_t local)
+{
+    time_t utc = local - _stdOffset;
+
+    if (_hasDst && isDst(utc) && isDst(local - _dstOffset)) {
+        utc = local - _dstOffset;
+    }
+
+    return utc;
+}
+
+/*!
+ * \brief Get local time offset.
+ * \param utc
+ *      Unix epoch UTC.
+ * \return
+ *      Offset east of UTC in seconds, including DST.
+ */
+int32_t ErriezDS1302TimeZone::getOffset(time_t utc)
+{
+    return isDst(utc) ? _dstOffset : _stdOffset;
+}
+
+/*!
+ * \brief Check daylight saving time.
+ * \param utc
+ *      Unix epoch UTC.
+ * \retval true
+ *      DST is active.
+ * \retval false
+ *      Standard time.
+ */
+bool ErriezDS1302TimeZone::isDst(time_t utc)
+{
+    uint32_t t = (uint32_t)utc;
+
+    if (!_hasDst) {
+        return false;
+    }
+
+    // Repeated calls are within the same offset interval most of the time
+    if (_cacheValid && (t >= _cacheStart) && (t < _cacheEnd)) {
+        return _cacheDst;
+    }
+
+    return lookupDst(t);
+}
+
+/*!
+ * \brief Read RTC running in UTC.
+ * \details
+ *      Unlike ErriezDS1302::getEpoch(), the result does not depend on the TZ setting of libc.
+ * \return
+ *      Unix epoch UTC, or 0 when the RTC read failed.
+ */
+time_t ErriezDS1302TimeZone::getUtc()
+{
+    struct tm dt;
+
+    if (!_rtc->read(&dt)) {
+        return 0;
+    }
+
+    return makeTime(&dt);
+}
+
+/*!
+ * \brief Read RTC running in UTC and convert to local time.
+ * \param dt
+ *      Local date and time struct tm. tm_isdst is set when DST is active.
+ * \retval true
+ *      Success.
+ * \retval false
+ *      RTC read failed.
+ */
+bool ErriezDS1302TimeZone::getLocal(struct tm *dt)
+{
+    time_t utc;
+
+    if (!_rtc->read(dt)) {
+        return false;
+    }
+
+    utc = makeTime(dt);
+    breakTime(toLocal(utc), dt);
+    dt->tm_isdst = isDst(utc) ? 1 : 0;
+
+    return true;
+}
+
+/*!
+ * \brief Convert date/time to seconds since 1970 without time zone.
+ * \param dt
+ *      Date/time struct tm, year 1970..2105.
+ * \return
+ *      Seconds since 1970-01-01 00:00:00.
+ */
+time_t ErriezDS1302TimeZone::makeTime(const struct tm *dt)
+{
+    uint32_t days = (uint32_t)daysFromCivil(dt->tm_year + 1900, dt->tm_mon + 1, dt->tm_mday);
+
+    return (time_t)((days * SECONDS_PER_DAY) + (dt->tm_hour * 3600UL) + (dt->tm_min * 60UL) +
+                    dt->tm_sec);
+}
+
+/*!
+ * \brief Convert seconds since 1970 to date/time without time zone.
+ * \param t
+ *      Seconds since 1970-01-01 00:00:00.
+ * \param dt
+ *      Date/time struct tm.
+ */
+void ErriezDS1302TimeZone::breakTime(time_t t, struct tm *dt)
+{
+    uint32_t secs = (uint32_t)t;
+    int32_t days = (int32_t)(secs / SECONDS_PER_DAY);
+    uint32_t sod = secs % SECONDS_PER_DAY;
+    int32_t era;
+    uint32_t doe;
+    uint32_t yoe;
+    uint32_t doy;
+    uint32_t mp;
+    int32_t year;
+    bool leap;
+
+    memset(dt, 0, sizeof(struct tm));
+
+    dt->tm_hour = sod / 3600;
+    dt->tm_min = (sod / 60) % 60;
+    dt->tm_sec = sod % 60;
+    dt->tm_wday = (days + 4) % 7; // 1970-01-01 is a Thursday
+
+    // Civil from days, eras of 400 years starting at 0000-03-01
+    days += 719468L;
+    era = days / 146097L;
+    doe = days - (era * 146097L);
+    yoe = (doe - (doe / 1460) + (doe / 36524) - (doe / 146096)) / 365;
+    year = yoe + (era * 400);
+    doy = doe - ((365 * yoe) + (yoe / 4) - (yoe / 100));
+    mp = ((5 * doy) + 2) / 153;
+    dt->tm_mday = doy - (((153 * mp) + 2) / 5) + 1;
+    dt->tm_mon = (mp < 10) ? (mp + 2) : (mp - 10);
+    if (dt->tm_mon <= 1) {
+        year++;
+    }
+    dt->tm_year = year - 1900;
+
+    // Day of the year, doy counts from March 1
+    leap = ((year % 4) == 0) && (((year % 100) != 0) || ((year % 400) == 0));
+    if (doy >= 306) {
+        dt->tm_yday = doy - 306;
+    } else {
+        dt->tm_yday = doy + 59 + (leap ? 1 : 0);
+    }
+}
+
+// -------------------------------------------------------------------------------------------------
+// Private functions
+// -------------------------------------------------------------------------------------------------
+/*!
+ * \brief Find DST state in the transition table and cache the interval.
+ * \param utc
+ *      Unix epoch UTC.
+ * \retval true
+ *      DST is active.
+ * \retval false
+ *      Standard time.
+ */
+bool ErriezDS1302TimeZone::lookupDst(uint32_t utc)
+{
+    uint32_t start;
+    uint32_t end;
+    struct tm dt;
+    uint8_t lo = 0;
+    uint8_t hi = _numTransitions;
+    uint8_t mid;
+
+    if ((_numTransitions == 0) || (utc < _transitions[0]) ||
+        (utc >= _transitions[_numTransitions - 1])) {
+        // Outside table: calculate transitions of this year from the rule
+        breakTime((time_t)utc, &dt);
+        yearTransitions(dt.tm_year + 1900, &start, &end);
+        if (start < end) {
+            return (utc >= start) && (utc < end);
+        } else {
+            return (utc >= start) || (utc < end);
+        }
+    }
+
+    // Number of transitions <= utc
+    while (lo < hi) {
+        mid = (lo + hi) / 2;
+        if (_transitions[mid] <= utc) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    // Transitions alternate between DST start and DST end
+    _cacheStart = _transitions[lo - 1];
+    _cacheEnd = _transitions[lo];
+    _cacheDst = (((lo - 1) & 1) == 0) ? _firstIsDst : !_firstIsDst;
+    _cacheValid = true;
+
+    return _cacheDst;
+}
+
+/*!
+ * \brief Calculate DST start and end of a year.
+ * \param year
+ *      Year.
+ * \param start
+ *      DST start instant UTC.
+ * \param end
+ *      DST end instant UTC.
+ */
+void ErriezDS1302TimeZone::yearTransitions(uint16_t year, uint32_t *start, uint32_t *end)
+{
+    // Start is specified in standard time, end in daylight saving time
+    *start = ruleToUtc(year, &_start, _stdOffset);
+    *end = ruleToUtc(year, &_end, _dstOffset);
+}
+
+/*!
+ * \brief Convert transition rule to UTC instant.
+ * \param year
+ *      Year.
+ * \param rule
+ *      Transition rule.
+ * \param offset
+ *      Local time offset east of UTC before the transition.
+ * \return
+ *      Transition instant UTC.
+ */
+uint32_t ErriezDS1302TimeZone::ruleToUtc(uint16_t year, const DS1302TzRule *rule, int32_t offset)
+{
+    static const uint8_t daysInMonth[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+    bool leap = ((year % 4) == 0) && (((year % 100) != 0) || ((year % 400) == 0));
+    int32_t days = daysFromCivil(year, 1, 1);
+    uint8_t mdays;
+    uint8_t mday;
+    uint8_t wday;
+
+    if (rule->type == 'J') {
+        // Julian day 1..365, February 29 is never counted
+        days += rule->day - 1;
+        if (leap && (rule->day >= 60)) {
+            days++;
+        }
+    } else if (rule->type == 'D') {
+        // Zero based day 0..365
+        days += rule->day;
+    } else {
+        // Day of the week in week 1..5 of month
+        days = daysFromCivil(year, rule->month, 1);
+        wday = (days + 4) % 7;
+        mday = 1 + ((rule->day + 7 - wday) % 7) + ((rule->week - 1) * 7);
+        mdays = daysInMonth[rule->month - 1] + ((leap && (rule->month == 2)) ? 1 : 0);
+        while (mday > mdays) {
+            mday -= 7;
+        }
+        days += mday - 1;
+    }
+
+    return ((uint32_t)days * SECONDS_PER_DAY) + rule->time - offset;
+}
+
+/*!
+ * \brief Skip time zone name.
+ * \param p
+ *      Alphabetic name of at least 3 characters, or quoted <name>.
+ * \return
+ *      Next character, or NULL when invalid.
+ */
+const char *ErriezDS1302TimeZone::parseName(const char *p)
+{
+    const char *name = p;
+
+    if (*p == '<') {
+        while (*p && (*p != '>')) {
+            p++;
+        }
+        return (*p == '>') ? (p + 1) : NULL;
+    }
+
+    while (((*p >= 'A') && (*p <= 'Z')) || ((*p >= 'a') && (*p <= 'z'))) {
+        p++;
+    }
+
+    return ((p - name) >= 3) ? p : NULL;
+}
+
+/*!
+ * \brief Parse [+-]hh[:mm[:ss]].
+ * \param p
+ *      Time string.
+ * \param seconds
+ *      Time in seconds.
+ * \return
+ *      Next character, or NULL when invalid.
+ */
+const char *ErriezDS1302TimeZone::parseTime(const char *p, int32_t *seconds)
+{
+    int32_t value = 0;
+    int32_t field;
+    bool negative = false;
+    uint8_t i;
+
+    if ((*p == '+') || (*p == '-')) {
+        negative = (*p == '-');
+        p++;
+    }
+    if ((*p < '0') || (*p > '9')) {
+        return NULL;
+    }
+
+    for (i = 0; i < 3; i++) {
+        field = 0;
+        while ((*p >= '0') && (*p <= '9')) {
+            field = (field * 10) + (*p++ - '0');
+        }
+        value += field * ((i == 0) ? 3600L : ((i == 1) ? 60L : 1L));
+        if ((*p != ':') || (p[1] < '0') || (p[1] > '9')) {
+            break;
+        }
+        p++;
+    }
+
+    *seconds = negative ? -value : value;
+
+    return p;
+}
+
+/*!
+ * \brief Parse transition rule date[/time].
+ * \param p
+ *      Rule string: Jn, n or Mm.w.d, optionally followed by /time. Default time is 02:00:00.
+ * \param rule
+ *      Parsed rule.
+ * \return
+ *      Next character, or NULL when invalid.
+ */
+const char *ErriezDS1302TimeZone::parseRule(const char *p, DS1302TzRule *rule)
+{
+    uint16_t values[3] = { 0, 0, 0 };
+    uint8_t num = 0;
+
+    rule->type = 'D';
+    if ((*p == 'J') || (*p == 'M')) {
+        rule->type = *p++;
+    }
+
+    // Parse one or three numbers separated by dots
+    while (num < 3) {
+        if ((*p < '0') || (*p > '9')) {
+            return NULL;
+        }
+        while ((*p >= '0') && (*p <= '9')) {
+            values[num] = (values[num] * 10) + (*p++ - '0');
+        }
+        num++;
+        if ((rule->type != 'M') || (*p != '.')) {
+            break;
+        }
+        p++;
+    }
+
+    if (rule->type == 'M') {
+        if ((num != 3) || (values[0] < 1) || (values[0] > 12) || (values[1] < 1) ||
+            (values[1] > 5) || (values[2] > 6)) {
+            return NULL;
+        }
+        rule->month = values[0];
+        rule->week = values[1];
+        rule->day = values[2];
+    } else {
+        if (((rule->type == 'J') && ((values[0] < 1) || (values[0] > 365))) || (values[0] > 365)) {
+            return NULL;
+        }
+        rule->day = values[0];
+    }
+
+    rule->time = 7200;
+    if (*p == '/') {
+        p = parseTime(p + 1, &rule->time);
+    }
+
+    return p;
+}
+
+/*!
+ * \brief Number of days since 1970-01-01.
+ * \param year
+ *      Year.
+ * \param mon
+ *      Month 1..12.
+ * \param mday
+ *      Day of the month 1..31.
+ * \return
+ *      Days since 1970-01-01.
+ */
+int32_t ErriezDS1302TimeZone::daysFromCivil(int16_t year, uint8_t mon, uint8_t mday)
+{
+    int32_t era;
+    uint32_t yoe;
+    uint32_t doy;
+
+    // Eras of 400 years starting at 0000-03-01
+    if (mon <= 2) {
+        year--;
+    }
+    era = year / 400;
+    yoe = year - (era * 400);
+    doy = (((153 * ((mon > 2) ? (mon - 3) : (mon + 9))) + 2) / 5) + mday - 1;
+
+    return (era * 146097L) + (yoe * 365L) + (yoe / 4) - (yoe / 100) + doy - 719468L;
+}
+
+#endif // DS1302_FEATURE_TM
@@ -0,0 +1,117 @@
+/*
+ * MIT License
+ *
+ * Copyright (c) 2020 Erriez
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*!
+ * \file ErriezDS1302TimeZone.h
+ * \brief DS1302 RTC local time with POSIX TZ rules
+ * \details
+ *      Source:         https://github.com/Erriez/ErriezDS1302
+ *      Documentation:  https://erriez.github.io/ErriezDS1302
+ */
+
+#ifndef ERRIEZ_DS1302_TIME_ZONE_H_
+#define ERRIEZ_DS1302_TIME_ZONE_H_
+
+#include "ErriezDS1302.h"
+
+#if DS1302_FEATURE_TM
+
+//! Number of years in the transition table
+#ifndef DS1302_TZ_NUM_YEARS
+#ifdef __AVR
+#define DS1302_TZ_NUM_YEARS     20
+#else
+#define DS1302_TZ_NUM_YEARS     100
+#endif
+#endif
+
+#if DS1302_TZ_NUM_YEARS > 127
+#error "DS1302_TZ_NUM_YEARS must be <= 127"
+#endif
+
+//! Two DST transitions per year
+#define DS1302_TZ_MAX_TRANSITIONS   (DS1302_TZ_NUM_YEARS * 2)
+
+//! DST transition rule
+struct DS1302TzRule {
+    uint8_t type;       //!< 'J': Julian day 1..365, 'D': zero based day 0..365, 'M': month.week.day
+    uint16_t day;       //!< Julian day, zero based day or day of the week 0..6
+    uint8_t week;       //!< Week of the month 1..5 (5=last)
+    uint8_t month;      //!< Month 1..12
+    int32_t time;       //!< Local time of day in seconds
+};
+
+//! DS1302 RTC time zone class
+class ErriezDS1302TimeZone
+{
+public:
+    // Constructor
+    ErriezDS1302TimeZone(ErriezDS1302 *rtc);
+    bool begin(const char *tz, uint16_t firstYear=2000);
+
+    // UTC <-> local conversions
+    time_t toLocal(time_t utc);
+    time_t toUtc(time_t local);
+    int32_t getOffset(time_t utc);
+    bool isDst(time_t utc);
+
+    // Read RTC running in UTC
+    time_t getUtc();
+    bool getLocal(struct tm *dt);
+
+    // TZ independent struct tm <-> Unix epoch conversions
+    static time_t makeTime(const struct tm *dt);
+    static void breakTime(time_t t, struct tm *dt);
+
+private:
+    ErriezDS1302 *_rtc;                                 //!< RTC
+
+    int32_t _stdOffset;                                 //!< Standard time offset east of UTC
+    int32_t _dstOffset;                                 //!< Daylight saving time offset east of UTC
+    bool _hasDst;                                       //!< Time zone has daylight saving time
+    DS1302TzRule _start;                                //!< DST start rule
+    DS1302TzRule _end;                                  //!< DST end rule
+
+    uint32_t _transitions[DS1302_TZ_MAX_TRANSITIONS];   //!< Sorted UTC transition instants
+    uint8_t _numTransitions;                            //!< Number of transitions
+    bool _firstIsDst;                                   //!< First transition starts DST
+
+    uint32_t _cacheStart;                               //!< Cached interval start (inclusive)
+    uint32_t _cacheEnd;                                 //!< Cached interval end (exclusive)
+    bool _cacheDst;                                     //!< Cached interval is DST
+    bool _cacheValid;                                   //!< Cached interval valid
+
+    bool lookupDst(uint32_t utc);
+    void yearTransitions(uint16_t year, uint32_t *start, uint32_t *end);
+    uint32_t ruleToUtc(uint16_t year, const DS1302TzRule *rule, int32_t offset);
+
+    static const char *parseName(const char *p);
+    static const char *parseTime(const char *p, int32_t *seconds);
+    static const char *parseRule(const char *p, DS1302TzRule *rule);
+    static int32_t daysFromCivil(int16_t year, uint8_t mon, uint8_t mday);
+};
+
+#endif // DS1302_FEATURE_TM
+
+#endif // ERRIEZ_DS1302_TIME_ZONE_H_